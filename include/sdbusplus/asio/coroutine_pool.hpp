@@ -0,0 +1,238 @@
+#pragma once
+
+#ifndef BOOST_COROUTINES_NO_DEPRECATION_WARNING
+// users should define this if they directly include boost/asio/spawn.hpp,
+// but by defining it here, warnings won't cause problems with a compile
+#define BOOST_COROUTINES_NO_DEPRECATION_WARNING
+#endif
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/stack_traits.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sdbusplus::asio
+{
+
+/** @struct coroutine_options
+ *  @brief Settings for running yield_context method handlers.
+ */
+struct coroutine_options
+{
+    /** Size of each coroutine stack, in bytes. */
+    size_t stack_size = boost::context::stack_traits::default_size();
+    /** Number of idle stacks kept for reuse; 0 disables pooling. */
+    size_t max_cached_stacks = 16;
+    /** Number of handlers allowed to run at once; 0 is unlimited.  Calls
+     *  beyond the limit wait, in order, for a running handler to finish. */
+    size_t max_concurrent = 0;
+};
+
+/** @struct coroutine_stats
+ *  @brief Counters describing the use of a coroutine_pool.
+ */
+struct coroutine_stats
+{
+    /** Stacks allocated from the system. */
+    size_t stacks_allocated = 0;
+    /** Stacks handed out again from the pool. */
+    size_t stacks_reused = 0;
+    /** Idle stacks currently held in the pool. */
+    size_t stacks_cached = 0;
+    /** Handlers currently running. */
+    size_t active = 0;
+    /** Highest value 'active' has reached. */
+    size_t peak_active = 0;
+    /** Calls currently waiting for a running handler to finish. */
+    size_t queued = 0;
+    /** Highest value 'queued' has reached. */
+    size_t peak_queued = 0;
+};
+
+/** @class coroutine_pool
+ *  @brief Runs coroutines on fixed-size stacks reused across calls, with an
+ *         optional limit on how many run at once.
+ *
+ *  One pool is shared by every coroutine method of an object_server.  Like
+ *  the rest of sdbusplus::asio, it must only be used from the thread running
+ *  the io_context.
+ */
+class coroutine_pool : public std::enable_shared_from_this<coroutine_pool>
+{
+  public:
+    explicit coroutine_pool(boost::asio::io_context& io,
+                            const coroutine_options& options = {}) :
+        io_(io), options_(options)
+    {}
+
+    coroutine_pool(const coroutine_pool&) = delete;
+    coroutine_pool& operator=(const coroutine_pool&) = delete;
+
+    ~coroutine_pool()
+    {
+        release_stacks();
+    }
+
+    /** @brief Change the pool settings.
+     *
+     *  Idle stacks of the old size are released.  Running handlers are not
+     *  affected, but a larger max_concurrent starts waiting calls now.
+     */
+    void set_options(const coroutine_options& options)
+    {
+        if (options.stack_size != options_.stack_size)
+        {
+            release_stacks();
+        }
+        options_ = options;
+        while (free_stacks_.size() > options_.max_cached_stacks)
+        {
+            deallocate_stack(free_stacks_.back());
+            free_stacks_.pop_back();
+        }
+        start_queued();
+    }
+
+    const coroutine_options& get_options() const
+    {
+        return options_;
+    }
+
+    coroutine_stats get_stats() const
+    {
+        coroutine_stats stats = stats_;
+        stats.stacks_cached = free_stacks_.size();
+        stats.queued = queue_.size();
+        return stats;
+    }
+
+    /** @brief Run 'function(yield)' in a new coroutine, or once a running
+     *         one finishes if max_concurrent has been reached.
+     */
+    template <typename Function>
+    void spawn(Function&& function)
+    {
+        if (at_limit())
+        {
+            queue_.emplace_back(std::forward<Function>(function));
+            stats_.peak_queued = std::max(stats_.peak_queued, queue_.size());
+            return;
+        }
+        start(std::forward<Function>(function));
+    }
+
+  private:
+    /** Stack allocator handed to boost::asio::spawn. */
+    class stack_allocator
+    {
+      public:
+        explicit stack_allocator(std::shared_ptr<coroutine_pool> pool) :
+            pool_(std::move(pool))
+        {}
+
+        boost::context::stack_context allocate()
+        {
+            return pool_->allocate_stack();
+        }
+
+        void deallocate(boost::context::stack_context& sctx)
+        {
+            pool_->release_stack(sctx);
+        }
+
+      private:
+        std::shared_ptr<coroutine_pool> pool_;
+    };
+
+    bool at_limit() const
+    {
+        return (options_.max_concurrent != 0) &&
+               (stats_.active >= options_.max_concurrent);
+    }
+
+    template <typename Function>
+    void start(Function&& function)
+    {
+        ++stats_.active;
+        stats_.peak_active = std::max(stats_.peak_active, stats_.active);
+
+        auto self = shared_from_this();
+        boost::asio::spawn(
+            io_, std::allocator_arg, stack_allocator{self},
+            std::forward<Function>(function), [self](std::exception_ptr e) {
+                --self->stats_.active;
+                self->start_queued();
+                if (e)
+                {
+                    std::rethrow_exception(e);
+                }
+            });
+    }
+
+    void start_queued()
+    {
+        while (!queue_.empty() && !at_limit())
+        {
+            auto function = std::move(queue_.front());
+            queue_.pop_front();
+            start(std::move(function));
+        }
+    }
+
+    boost::context::stack_context allocate_stack()
+    {
+        if (!free_stacks_.empty())
+        {
+            auto sctx = free_stacks_.back();
+            free_stacks_.pop_back();
+            ++stats_.stacks_reused;
+            return sctx;
+        }
+
+        ++stats_.stacks_allocated;
+        return boost::context::fixedsize_stack{options_.stack_size}.allocate();
+    }
+
+    void release_stack(boost::context::stack_context& sctx)
+    {
+        if ((sctx.size == options_.stack_size) &&
+            (free_stacks_.size() < options_.max_cached_stacks))
+        {
+            free_stacks_.push_back(sctx);
+            return;
+        }
+        deallocate_stack(sctx);
+    }
+
+    static void deallocate_stack(boost::context::stack_context& sctx)
+    {
+        boost::context::fixedsize_stack{sctx.size}.deallocate(sctx);
+    }
+
+    void release_stacks()
+    {
+        for (auto& sctx : free_stacks_)
+        {
+            deallocate_stack(sctx);
+        }
+        free_stacks_.clear();
+    }
+
+    boost::asio::io_context& io_;
+    coroutine_options options_;
+    coroutine_stats stats_;
+    std::vector<boost::context::stack_context> free_stacks_;
+    std::deque<std::function<void(boost::asio::yield_context)>> queue_;
+};
+
+} // namespace sdbusplus::asio
@@ -11,7 +11,9 @@
 #ifndef SDBUSPLUS_DISABLE_BOOST_COROUTINES
 #include <boost/asio/detached.hpp>
 #include <boost/asio/spawn.hpp>
+#include <sdbusplus/asio/coroutine_pool.hpp>
 #endif
+#include <boost/asio/steady_timer.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/exception.hpp>
 #include <sdbusplus/message/read.hpp>
@@ -21,6 +23,8 @@
 #include <sdbusplus/utility/type_traits.hpp>
 
 #include <any>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <optional>
 #include <utility>
@@ -48,11 +52,13 @@ class property_callback
         std::function<int(message_t&)>&& on_get,
         std::function<SetPropertyReturnValue(message_t&)>&& on_set_message,
         std::function<SetPropertyReturnValue(const std::any&)>&& on_set_value,
-        const char* signature, decltype(vtable_t::flags) flags) :
+        const char* signature, decltype(vtable_t::flags) flags,
+        sd_bus_property_get_t bound_get = nullptr,
+        const void* bound_value = nullptr) :
         interface_(parent), name_(name), on_get_(std::move(on_get)),
         on_set_message_(std::move(on_set_message)),
         on_set_value_(std::move(on_set_value)), signature_(signature),
-        flags_(flags)
+        flags_(flags), bound_get_(bound_get), bound_value_(bound_value)
     {}
     dbus_interface& interface_;
     std::string name_;
@@ -61,20 +67,35 @@ class property_callback
     std::function<SetPropertyReturnValue(const std::any&)> on_set_value_;
     const char* signature_;
     decltype(vtable_t::flags) flags_;
+    // For bound properties, the getter sd-bus calls with 'bound_value_'
+    // in place of on_get_.
+    sd_bus_property_get_t bound_get_;
+    const void* bound_value_;
 };
 
 class method_callback
 {
   public:
-    method_callback(const std::string& name,
-                    std::function<int(message_t&)>&& call,
+    /** @brief Hold a method handler of concrete type 'CallbackInstance'.
+     *
+     *  The instance is handed to sd-bus directly as the vtable userdata,
+     *  along with a handler specialized for its type, so a method call is
+     *  dispatched without going through any type-erased wrapper.
+     */
+    template <typename CallbackInstance>
+    method_callback(const std::string& name, CallbackInstance&& call,
+                    sd_bus_message_handler_t handler,
                     const char* arg_signature, const char* return_signature,
                     decltype(vtable_t::flags) flags) :
-        name_(name), call_(std::move(call)), arg_signature_(arg_signature),
+        name_(name),
+        call_(new CallbackInstance(std::forward<CallbackInstance>(call)),
+              [](void* p) { delete static_cast<CallbackInstance*>(p); }),
+        handler_(handler), arg_signature_(arg_signature),
         return_signature_(return_signature), flags_(flags)
     {}
     std::string name_;
-    std::function<int(message_t&)> call_;
+    std::unique_ptr<void, void (*)(void*)> call_;
+    sd_bus_message_handler_t handler_;
     const char* arg_signature_;
     const char* return_signature_;
     decltype(vtable_t::flags) flags_;
@@ -154,6 +175,51 @@ struct NonDbusArgsCount<std::tuple<FirstArg, OtherArgs...>>
     }
 };
 
+/** @brief Invoke a method handler with its decoded arguments.
+ *
+ *  The 'prefix' arguments (ex. yield_context, message_t) are passed first,
+ *  followed by the D-Bus arguments in 'dbusArgs'.  Every argument is
+ *  forwarded according to the handler's declared parameter type, so
+ *  by-value parameters are moved from the decoded storage rather than
+ *  copied, while reference parameters bind to it directly.
+ */
+template <typename Callback, typename DbusTuple, typename... Prefix>
+decltype(auto) invoke_method(Callback& callback, DbusTuple& dbusArgs,
+                             Prefix&... prefix)
+{
+    using Params = boost::callable_traits::args_t<Callback>;
+    constexpr std::size_t skip = sizeof...(Prefix);
+
+    auto prefixArgs = std::forward_as_tuple(prefix...);
+    return [&]<std::size_t... P, std::size_t... I>(
+               std::index_sequence<P...>,
+               std::index_sequence<I...>) -> decltype(auto) {
+        return callback(
+            std::forward<std::tuple_element_t<P, Params>>(
+                std::get<P>(prefixArgs))...,
+            std::forward<std::tuple_element_t<skip + I, Params>>(
+                std::get<I>(dbusArgs))...);
+    }(std::index_sequence_for<Prefix...>{},
+           std::make_index_sequence<std::tuple_size_v<DbusTuple>>{});
+}
+
+/** @brief Invoke a method handler and append its result to 'ret'. */
+template <typename Callback, typename DbusTuple, typename... Prefix>
+void call_method(message_t& ret, Callback& callback, DbusTuple& dbusArgs,
+                 Prefix&... prefix)
+{
+    using ResultType = boost::callable_traits::return_type_t<Callback>;
+    if constexpr (std::is_void_v<ResultType>)
+    {
+        invoke_method(callback, dbusArgs, prefix...);
+    }
+    else
+    {
+        auto r = invoke_method(callback, dbusArgs, prefix...);
+        ret.append(r);
+    }
+}
+
 template <typename PropertyType>
 PropertyType nop_get_value(const PropertyType& value)
 {
@@ -167,6 +233,44 @@ bool nop_set_value(const PropertyType& req, PropertyType& old)
     return true;
 }
 
+// Access to the storage of a bound property, which may be either a plain
+// value or a std::atomic.
+template <typename T>
+struct bound_value
+{
+    using type = std::remove_const_t<T>;
+
+    static const type& load(const T& v)
+    {
+        return v;
+    }
+
+    static void store(T& v, const type& value)
+    {
+        v = value;
+    }
+};
+
+template <typename T>
+struct bound_value<std::atomic<T>>
+{
+    using type = T;
+
+    static T load(const std::atomic<T>& v)
+    {
+        return v.load();
+    }
+
+    static void store(std::atomic<T>& v, const T& value)
+    {
+        v.store(value);
+    }
+};
+
+template <typename T>
+struct bound_value<const std::atomic<T>> : bound_value<std::atomic<T>>
+{};
+
 } // namespace details
 
 template <typename InputArgs, typename Callback>
@@ -211,13 +315,11 @@ class callback_method_instance
         auto ret = m.new_method_return();
         if constexpr (callbackWantsMessage<CallbackType>)
         {
-            InputTupleType inputArgs =
-                std::tuple_cat(std::forward_as_tuple(std::move(m)), dbusArgs);
-            callFunction(ret, inputArgs, func_);
+            details::call_method(ret, func_, dbusArgs, m);
         }
         else
         {
-            callFunction(ret, dbusArgs, func_);
+            details::call_method(ret, func_, dbusArgs);
         }
         ret.method_return();
         return 1;
@@ -231,7 +333,9 @@ class coroutine_method_instance
   public:
     using self_t = coroutine_method_instance<CallbackType>;
     coroutine_method_instance(boost::asio::io_context& io,
-                              CallbackType&& func) : io_(io), func_(func)
+                              CallbackType&& func,
+                              std::shared_ptr<coroutine_pool> pool = nullptr) :
+        io_(io), func_(func), pool_(std::move(pool))
     {}
 
     int operator()(message_t& m)
@@ -240,8 +344,16 @@ class coroutine_method_instance
         message_t b{m};
 
         // spawn off a new coroutine to handle the method call
-        boost::asio::spawn(io_, std::bind_front(&self_t::after_spawn, this, b),
-                           boost::asio::detached);
+        if (pool_)
+        {
+            pool_->spawn(std::bind_front(&self_t::after_spawn, this, b));
+        }
+        else
+        {
+            boost::asio::spawn(io_,
+                               std::bind_front(&self_t::after_spawn, this, b),
+                               boost::asio::detached);
+        }
 
         return 1;
     }
@@ -249,6 +361,7 @@ class coroutine_method_instance
   private:
     boost::asio::io_context& io_;
     CallbackType func_;
+    std::shared_ptr<coroutine_pool> pool_;
     void after_spawn(message_t b, boost::asio::yield_context yield)
     {
         using CallbackSignature = boost::callable_traits::args_t<CallbackType>;
@@ -272,16 +385,11 @@ class coroutine_method_instance
             auto ret = b.new_method_return();
             if constexpr (callbackWantsMessage<CallbackType>)
             {
-                InputTupleType inputArgs = std::tuple_cat(
-                    std::forward_as_tuple(std::move(yield)),
-                    std::forward_as_tuple(std::move(b)), dbusArgs);
-                callFunction(ret, inputArgs, func_);
+                details::call_method(ret, func_, dbusArgs, yield, b);
             }
             else
             {
-                InputTupleType inputArgs = std::tuple_cat(
-                    std::forward_as_tuple(std::move(yield)), dbusArgs);
-                callFunction(ret, inputArgs, func_);
+                details::call_method(ret, func_, dbusArgs, yield);
             }
             ret.method_return();
         }
@@ -407,8 +515,13 @@ class dbus_interface
 
     ~dbus_interface()
     {
-        conn_->emit_interfaces_removed(path_.str.c_str(),
-                                       std::vector<std::string>{name_});
+        // Nothing was ever announced for an interface that was never
+        // initialized (ex. a discarded object_transaction).
+        if (is_initialized())
+        {
+            conn_->emit_interfaces_removed(path_.str.c_str(),
+                                           std::vector<std::string>{name_});
+        }
     }
 
     template <typename PropertyType, typename CallbackTypeGet>
@@ -547,6 +660,69 @@ class dbus_interface
             std::forward<CallbackTypeGet>(getFunction));
     }
 
+    /** @brief Register a read-only property served straight from storage
+     *         owned by the application.
+     *
+     *  Gets are answered by serializing 'value' directly, without any
+     *  getter callback or intermediate copy.  'value' may be a std::atomic,
+     *  in which case it is load()'d for every Get.  The storage must
+     *  outlive this interface.
+     *
+     *  The application may update 'value' directly and then call
+     *  signal_property(), or use set_property() which writes through to
+     *  'value' (unless it is const) and signals when it changes.
+     *
+     *  @param[in] name - The property name.
+     *  @param[in] value - The application-owned storage for the property.
+     *  @param[in] flags - The vtable flags for the property.
+     */
+    template <typename PropertyType>
+    bool register_property_bound(
+        const std::string& name, PropertyType& value,
+        decltype(vtable_t::flags) flags = vtable::property_::emits_change)
+    {
+        using bound_t = details::bound_value<PropertyType>;
+        using value_t = typename bound_t::type;
+
+        // can only register once
+        if (is_initialized())
+        {
+            return false;
+        }
+        if (sd_bus_member_name_is_valid(name.c_str()) != 1)
+        {
+            return false;
+        }
+        static const auto type =
+            utility::tuple_to_array(message::types::type_id<value_t>());
+
+        std::function<SetPropertyReturnValue(const std::any&)> set_value;
+        if constexpr (!std::is_const_v<PropertyType>)
+        {
+            set_value = [&value](const std::any& v) {
+                const value_t& newValue = std::any_cast<const value_t&>(v);
+                if (bound_t::load(value) == newValue)
+                {
+                    return SetPropertyReturnValue::sameValueUpdated;
+                }
+                bound_t::store(value, newValue);
+                return SetPropertyReturnValue::valueUpdated;
+            };
+        }
+        else
+        {
+            set_value = [](const std::any&) {
+                return SetPropertyReturnValue::fail;
+            };
+        }
+
+        property_callbacks_.emplace_back(
+            *this, name, nullptr, nullptr, std::move(set_value), type.data(),
+            flags, bound_get_handler<PropertyType>, &value);
+
+        return true;
+    }
+
     template <typename PropertyType, bool changesOnly = false>
     bool set_property(const std::string& name, const PropertyType& value)
     {
@@ -565,7 +741,7 @@ class dbus_interface
             {
                 if (status != SetPropertyReturnValue::sameValueUpdated)
                 {
-                    signal_property(name);
+                    interface_->property_changed(name.c_str(), value);
                     return true;
                 }
                 if constexpr (!changesOnly)
@@ -616,18 +792,24 @@ class dbus_interface
         static const auto resultType =
             utility::tuple_to_array(message::types::type_id<ResultType>());
 
-        std::function<int(message_t&)> func;
         if constexpr (FirstArgIsYield_v<CallbackType>)
         {
-            func = coroutine_method_instance<CallbackType>(
-                conn_->get_io_context(), std::move(handler));
+            using instance_t = coroutine_method_instance<CallbackType>;
+            method_callbacks_.emplace_back(
+                name,
+                instance_t(conn_->get_io_context(), std::move(handler),
+                           coroutines_),
+                method_handler<instance_t>, argType.data(), resultType.data(),
+                flags);
         }
         else
         {
-            func = callback_method_instance<CallbackType>(std::move(handler));
+            using instance_t = callback_method_instance<CallbackType>;
+            method_callbacks_.emplace_back(
+                name, instance_t(std::move(handler)),
+                method_handler<instance_t>, argType.data(), resultType.data(),
+                flags);
         }
-        method_callbacks_.emplace_back(name, std::move(func), argType.data(),
-                                       resultType.data(), flags);
 
         return true;
     }
@@ -660,6 +842,37 @@ class dbus_interface
                                       nullptr);
     }
 
+    template <typename PropertyType>
+    static int bound_get_handler(sd_bus* /*bus*/, const char* /*path*/,
+                                 const char* /*interface*/,
+                                 const char* /*property*/,
+                                 sd_bus_message* reply, void* userdata,
+                                 sd_bus_error* error)
+    {
+        using bound_t = details::bound_value<PropertyType>;
+        const auto* value = static_cast<const PropertyType*>(userdata);
+#ifdef __EXCEPTIONS
+        try
+        {
+#endif
+            message::append(&sdbus_impl, reply, bound_t::load(*value));
+            return 1;
+#ifdef __EXCEPTIONS
+        }
+
+        catch (const sdbusplus::exception_t& e)
+        {
+            return e.set_error(error);
+        }
+        catch (...)
+        {
+            // hit default error below
+        }
+#endif
+        return sd_bus_error_set_const(error, SD_BUS_ERROR_INVALID_ARGS,
+                                      nullptr);
+    }
+
     static int set_handler(sd_bus* /*bus*/, const char* /*path*/,
                            const char* /*interface*/, const char* /*property*/,
                            sd_bus_message* value, void* userdata,
@@ -700,16 +913,17 @@ class dbus_interface
                                       nullptr);
     }
 
+    template <typename CallbackInstance>
     static int method_handler(sd_bus_message* m, void* userdata,
                               sd_bus_error* error)
     {
-        method_callback* func = static_cast<method_callback*>(userdata);
+        auto* func = static_cast<CallbackInstance*>(userdata);
         auto mesg = message_t(m);
 #ifdef __EXCEPTIONS
         try
         {
 #endif
-            int status = func->call_(mesg);
+            int status = (*func)(mesg);
             if (status == 1)
             {
                 return status;
@@ -744,6 +958,32 @@ class dbus_interface
     }
 
     bool initialize(const bool skipPropertyChangedSignal = false)
+    {
+        if (!register_vtable())
+        {
+            return false;
+        }
+        conn_->emit_interfaces_added(path_.str.c_str(),
+                                     std::vector<std::string>{name_});
+        if (!skipPropertyChangedSignal)
+        {
+            for (const auto& element : property_callbacks_)
+            {
+                signal_property(element.name_);
+            }
+        }
+        return true;
+    }
+
+    /** @brief Export the interface on the bus without announcing it.
+     *
+     *  Builds the vtable and registers it with sd-bus, but sends neither
+     *  InterfacesAdded nor PropertiesChanged.  The caller is responsible
+     *  for emitting InterfacesAdded (see object_transaction).
+     *
+     *  @return false if the interface was already initialized.
+     */
+    bool register_vtable()
     {
         // can only register once
         if (is_initialized())
@@ -756,7 +996,15 @@ class dbus_interface
         property_callbacks_.shrink_to_fit();
         for (auto& element : property_callbacks_)
         {
-            if (element.on_set_message_)
+            if (element.bound_get_)
+            {
+                vtable_.emplace_back(vtable::property_o(
+                    element.name_.c_str(), element.signature_,
+                    element.bound_get_,
+                    reinterpret_cast<size_t>(element.bound_value_),
+                    element.flags_ | SD_BUS_VTABLE_ABSOLUTE_OFFSET));
+            }
+            else if (element.on_set_message_)
             {
                 vtable_.emplace_back(vtable::property_o(
                     element.name_.c_str(), element.signature_, get_handler,
@@ -777,8 +1025,8 @@ class dbus_interface
         {
             vtable_.emplace_back(vtable::method_o(
                 element.name_.c_str(), element.arg_signature_,
-                element.return_signature_, method_handler,
-                reinterpret_cast<size_t>(&element),
+                element.return_signature_, element.handler_,
+                reinterpret_cast<size_t>(element.call_.get()),
                 element.flags_ | SD_BUS_VTABLE_ABSOLUTE_OFFSET));
         }
 
@@ -796,18 +1044,32 @@ class dbus_interface
                            path_.str.c_str(), name_.c_str(),
                            static_cast<const sd_bus_vtable*>(&vtable_[0]),
                            nullptr);
-        conn_->emit_interfaces_added(path_.str.c_str(),
-                                     std::vector<std::string>{name_});
-        if (!skipPropertyChangedSignal)
+        for (const auto& [name, policy] : signal_policies_)
         {
-            for (const auto& element : property_callbacks_)
-            {
-                signal_property(element.name_);
-            }
+            apply_signal_policy(name, policy);
         }
         return true;
     }
 
+    /** @brief Limit the PropertiesChanged signals sent by set_property()
+     *         for a property.
+     *
+     *  Signals sent by signal_property(), or for a Set call from a client,
+     *  are not limited.
+     *
+     *  @param[in] name - The property name.
+     *  @param[in] policy - The signalling policy to apply.
+     */
+    void set_signal_policy(const std::string& name,
+                           const sdbusplus::server::signal_policy& policy)
+    {
+        signal_policies_.emplace_back(name, policy);
+        if (is_initialized())
+        {
+            apply_signal_policy(name, policy);
+        }
+    }
+
     bool is_initialized()
     {
         return interface_.has_value();
@@ -834,6 +1096,29 @@ class dbus_interface
     }
 
   private:
+    void apply_signal_policy(const std::string& name,
+                             const sdbusplus::server::signal_policy& policy)
+    {
+        if (!signal_timer_)
+        {
+            signal_timer_.emplace(conn_->get_io_context());
+            interface_->set_signal_timer(
+                [this](std::chrono::microseconds delay,
+                       sdbusplus::server::interface_t::signal_flush flush) {
+                    signal_timer_->expires_after(delay);
+                    signal_timer_->async_wait(
+                        [flush = std::move(flush)](
+                            const boost::system::error_code& ec) {
+                            if (!ec)
+                            {
+                                flush();
+                            }
+                        });
+                });
+        }
+        interface_->set_signal_policy(name.c_str(), policy);
+    }
+
     std::shared_ptr<sdbusplus::asio::connection> conn_;
     sdbusplus::object_path path_;
     std::string name_;
@@ -843,15 +1128,29 @@ class dbus_interface
     std::vector<method_callback> method_callbacks_;
 
     std::vector<sd_bus_vtable> vtable_;
+    std::vector<std::pair<std::string, sdbusplus::server::signal_policy>>
+        signal_policies_;
+    std::optional<boost::asio::steady_timer> signal_timer_;
     std::optional<sdbusplus::server::interface_t> interface_;
+#ifndef SDBUSPLUS_DISABLE_BOOST_COROUTINES
+    std::shared_ptr<coroutine_pool> coroutines_;
+#endif
+
+    friend class object_server;
 };
 
+class object_transaction;
+
 class object_server
 {
   public:
     object_server(const std::shared_ptr<sdbusplus::asio::connection>& conn,
                   const bool skipManager = false) : conn_(conn)
     {
+#ifndef SDBUSPLUS_DISABLE_BOOST_COROUTINES
+        coroutines_ =
+            std::make_shared<coroutine_pool>(conn_->get_io_context());
+#endif
         if (!skipManager)
         {
             add_manager("/");
@@ -862,10 +1161,35 @@ class object_server
                                                   const std::string& name)
     {
         auto dbusIface = std::make_shared<dbus_interface>(conn_, path, name);
+#ifndef SDBUSPLUS_DISABLE_BOOST_COROUTINES
+        dbusIface->coroutines_ = coroutines_;
+#endif
         interfaces_.emplace_back(dbusIface);
         return dbusIface;
     }
 
+#ifndef SDBUSPLUS_DISABLE_BOOST_COROUTINES
+    /** @brief Configure stack pooling and the concurrency limit for the
+     *         yield_context methods of every interface on this server.
+     */
+    void set_coroutine_options(const coroutine_options& options)
+    {
+        coroutines_->set_options(options);
+    }
+
+    coroutine_stats get_coroutine_stats() const
+    {
+        return coroutines_->get_stats();
+    }
+#endif
+
+    /** @brief Start building an object whose interfaces are published
+     *         together.
+     *
+     *  @param[in] path - The object path all interfaces will live on.
+     */
+    object_transaction begin_transaction(const std::string& path);
+
     void add_manager(const std::string& path)
     {
         managers_.emplace_back(static_cast<sdbusplus::bus_t&>(*conn_),
@@ -885,10 +1209,114 @@ class object_server
     }
 
   private:
+    friend class object_transaction;
+
     std::shared_ptr<sdbusplus::asio::connection> conn_;
     std::vector<std::shared_ptr<dbus_interface>> interfaces_;
     std::vector<server::manager_t> managers_;
+#ifndef SDBUSPLUS_DISABLE_BOOST_COROUTINES
+    std::shared_ptr<coroutine_pool> coroutines_;
+#endif
+};
+
+/** @class object_transaction
+ *  @brief Registers several interfaces on one path and publishes them with a
+ *         single InterfacesAdded signal.
+ *
+ *  Interfaces created through add_interface() are owned by the object_server
+ *  like any other, but nothing is exported until commit().  commit()
+ *  registers every vtable and then emits one InterfacesAdded carrying all of
+ *  the interfaces and their initial property values; no PropertiesChanged
+ *  signals are sent for the initial values.
+ *
+ *  A transaction destroyed without being committed removes its interfaces
+ *  from the object_server without emitting anything.
+ */
+class object_transaction
+{
+  public:
+    object_transaction(object_server& server, const std::string& path) :
+        server_(server), path_(path)
+    {}
+
+    object_transaction(const object_transaction&) = delete;
+    object_transaction& operator=(const object_transaction&) = delete;
+    object_transaction(object_transaction&&) = delete;
+    object_transaction& operator=(object_transaction&&) = delete;
+
+    ~object_transaction()
+    {
+        if (!committed_)
+        {
+            for (const auto& iface : interfaces_)
+            {
+                server_.remove_interface(iface);
+            }
+        }
+    }
+
+    /** @brief Add an interface to the pending object.
+     *
+     *  The returned interface should have its properties, methods, and
+     *  signals registered, but must not be initialize()'d by the caller.
+     *
+     *  @param[in] name - The interface name.
+     */
+    std::shared_ptr<dbus_interface> add_interface(const std::string& name)
+    {
+        if (committed_)
+        {
+            return nullptr;
+        }
+        auto iface = server_.add_interface(path_, name);
+        interfaces_.emplace_back(iface);
+        return iface;
+    }
+
+    /** @brief Export all interfaces and emit a single InterfacesAdded.
+     *
+     *  Interfaces which were already initialized by the caller are left
+     *  out of the signal, since they have been announced already.
+     *
+     *  @return false if the transaction was already committed.
+     */
+    bool commit()
+    {
+        if (committed_)
+        {
+            return false;
+        }
+        committed_ = true;
+
+        std::vector<std::string> names;
+        names.reserve(interfaces_.size());
+        for (const auto& iface : interfaces_)
+        {
+            if (iface->register_vtable())
+            {
+                names.emplace_back(iface->get_interface_name());
+            }
+        }
+
+        if (!names.empty())
+        {
+            server_.conn_->emit_interfaces_added(path_.c_str(), names);
+        }
+        return true;
+    }
+
+  private:
+    object_server& server_;
+    std::string path_;
+    std::vector<std::shared_ptr<dbus_interface>> interfaces_;
+    bool committed_ = false;
 };
 
+inline object_transaction object_server::begin_transaction(
+    const std::string& path)
+{
+    return object_transaction(*this, path);
+}
+
 } // namespace asio
 } // namespace sdbusplus
@@ -0,0 +1,362 @@
+#pragma once
+
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/cancellation_signal.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+#include <sdbusplus/async/execution.hpp>
+
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/* Bridges between the Senders of `sdbusplus::async` and boost::asio, so that
+ * a daemon mixing `asio::connection` code with coroutine tasks runs a single
+ * event loop:
+ *
+ *   - `asio::scheduler` runs Senders, such as `async::task`s, on an
+ *     `io_context`, and `asio::spawn` starts them there.  The proxy
+ *     operations of `sdbusplus::async` can be given an `asio::connection`
+ *     in place of a context; the connection's processing of the bus then
+ *     resumes the awaiting tasks.
+ *   - `asio::use_sender` turns an asio asynchronous operation into a Sender,
+ *     for tasks to `co_await`.
+ *
+ * Everything runs on the thread running the `io_context`, as the rest of
+ * sdbusplus' asio support does; the `io_context` is not thread-safe when
+ * built with BOOST_ASIO_DISABLE_THREADS.
+ */
+
+namespace sdbusplus::asio
+{
+
+namespace execution = sdbusplus::async::execution;
+
+/** A Scheduler running its work on a boost::asio::io_context.
+ *
+ *  The work is posted to the `io_context`, and so runs from its `run`.
+ */
+class scheduler
+{
+    template <execution::receiver R>
+    struct operation
+    {
+        operation(boost::asio::io_context* io, R r) :
+            io(io), receiver(std::move(r))
+        {}
+
+        operation(operation&&) = delete;
+
+        void start() noexcept
+        {
+            boost::asio::post(*io, [this]() {
+                if (execution::get_stop_token(execution::get_env(receiver))
+                        .stop_requested())
+                {
+                    execution::set_stopped(std::move(receiver));
+                }
+                else
+                {
+                    execution::set_value(std::move(receiver));
+                }
+            });
+        }
+
+        boost::asio::io_context* io;
+        R receiver;
+    };
+
+    struct schedule_env
+    {
+        template <typename CPO>
+        auto query(execution::get_completion_scheduler_t<CPO>) const noexcept
+            -> scheduler
+        {
+            return scheduler{*io};
+        }
+
+        boost::asio::io_context* io;
+    };
+
+    struct schedule_sender
+    {
+        using sender_concept = execution::sender_t;
+
+        template <typename Self, class... Env>
+        static constexpr auto get_completion_signatures(Self&&, Env&&...)
+            -> execution::completion_signatures<execution::set_value_t(),
+                                                execution::set_stopped_t()>;
+
+        template <execution::receiver R>
+        auto connect(R r) const -> operation<R>
+        {
+            return {io, std::move(r)};
+        }
+
+        auto get_env() const noexcept -> schedule_env
+        {
+            return {io};
+        }
+
+        boost::asio::io_context* io;
+    };
+
+  public:
+    using scheduler_concept = execution::scheduler_t;
+
+    explicit scheduler(boost::asio::io_context& io) noexcept : io(&io) {}
+
+    auto schedule() const noexcept -> schedule_sender
+    {
+        return {io};
+    }
+
+    auto query(execution::get_forward_progress_guarantee_t) const noexcept
+        -> execution::forward_progress_guarantee
+    {
+        return execution::forward_progress_guarantee::parallel;
+    }
+
+    bool operator==(const scheduler&) const noexcept = default;
+
+  private:
+    boost::asio::io_context* io;
+};
+
+/** Spawn a Sender to run on an io_context.
+ *
+ *  The Sender is started from the `io_context`, and must complete before
+ *  the `io_context` is destroyed.  As with `async::context::spawn`, it
+ *  should handle its own errors.
+ *
+ *  @param[in] io - The io_context to run the Sender on.
+ *  @param[in] sender - The Sender to run.
+ */
+template <execution::sender Snd>
+void spawn(boost::asio::io_context& io, Snd&& sender)
+{
+    execution::start_detached(
+        execution::starts_on(scheduler(io), std::forward<Snd>(sender)));
+}
+
+/** A completion token turning an asio asynchronous operation into a Sender.
+ *
+ *  ```
+ *      boost::asio::steady_timer timer(io, 1s);
+ *      co_await timer.async_wait(sdbusplus::asio::use_sender);
+ *  ```
+ *
+ *  The Sender starts the operation when it is started, and completes with
+ *  the arguments of the operation's handler.  A leading error_code is not
+ *  passed on: an error is sent as a `boost::system::system_error` instead.
+ *  A stop request on the Receiver cancels the operation through its
+ *  cancellation slot, and the Sender completes as stopped; as with the
+ *  operation itself, the stop request must come from the `io_context`'s
+ *  thread.
+ *
+ *  The Sender completes on the `io_context`'s thread; a task running on an
+ *  `async::context` can return to it with `execution::continues_on`.
+ */
+struct use_sender_t
+{};
+inline constexpr use_sender_t use_sender{};
+
+namespace sender_ns
+{
+
+/* The completion of a handler signature, less a leading error_code. */
+template <typename... Args>
+struct completion
+{
+    static constexpr bool has_error_code = false;
+
+    using signatures = execution::completion_signatures<
+        execution::set_value_t(std::decay_t<Args>...),
+        execution::set_error_t(std::exception_ptr), execution::set_stopped_t()>;
+};
+
+template <typename... Args>
+struct completion<boost::system::error_code, Args...>
+{
+    static constexpr bool has_error_code = true;
+
+    using signatures = execution::completion_signatures<
+        execution::set_value_t(std::decay_t<Args>...),
+        execution::set_error_t(std::exception_ptr), execution::set_stopped_t()>;
+};
+
+template <typename... Args>
+struct completion<const boost::system::error_code&, Args...> :
+    completion<boost::system::error_code, Args...>
+{};
+
+template <typename Signature, typename Init, typename Args,
+          execution::receiver R>
+struct operation;
+
+template <typename... Sig, typename Init, typename... InitArgs,
+          execution::receiver R>
+struct operation<void(Sig...), Init, std::tuple<InitArgs...>, R>
+{
+    operation(Init&& init, std::tuple<InitArgs...>&& args, R&& r) :
+        init(std::move(init)), args(std::move(args)), receiver(std::move(r))
+    {}
+
+    operation(operation&&) = delete;
+
+    /* The handler given to the asio operation. */
+    struct handler
+    {
+        using cancellation_slot_type = boost::asio::cancellation_slot;
+
+        auto get_cancellation_slot() const noexcept -> cancellation_slot_type
+        {
+            return self->signal.slot();
+        }
+
+        void operator()(Sig... values)
+        {
+            self->complete(std::forward<Sig>(values)...);
+        }
+
+        operation* self;
+    };
+
+    void start() noexcept
+    {
+        auto token = execution::get_stop_token(execution::get_env(receiver));
+        if (token.stop_requested())
+        {
+            execution::set_stopped(std::move(receiver));
+            return;
+        }
+
+        try
+        {
+            std::apply(
+                [this](auto&&... a) {
+                    std::move(init)(handler{this},
+                                    std::forward<decltype(a)>(a)...);
+                },
+                std::move(args));
+        }
+        catch (...)
+        {
+            execution::set_error(std::move(receiver), std::current_exception());
+            return;
+        }
+
+        // An asio operation never calls its handler from the initiation, so
+        // the cancellation is in place before the operation can complete.
+        stop_callback.emplace(std::move(token), stop_requested{this});
+    }
+
+  private:
+    using completion_t = completion<Sig...>;
+
+    struct stop_requested
+    {
+        void operator()() noexcept
+        {
+            self->stopped = true;
+            self->signal.emit(boost::asio::cancellation_type::terminal);
+        }
+
+        operation* self;
+    };
+
+    template <typename... Vs>
+    void complete(boost::system::error_code ec, Vs&&... values)
+        requires(completion_t::has_error_code)
+    {
+        stop_callback.reset();
+
+        if (stopped && (ec == boost::asio::error::operation_aborted))
+        {
+            execution::set_stopped(std::move(receiver));
+        }
+        else if (ec)
+        {
+            execution::set_error(
+                std::move(receiver),
+                std::make_exception_ptr(boost::system::system_error(ec)));
+        }
+        else
+        {
+            execution::set_value(std::move(receiver),
+                                 std::forward<Vs>(values)...);
+        }
+    }
+
+    template <typename... Vs>
+    void complete(Vs&&... values)
+        requires(!completion_t::has_error_code)
+    {
+        stop_callback.reset();
+        execution::set_value(std::move(receiver), std::forward<Vs>(values)...);
+    }
+
+    using stop_token_t =
+        execution::stop_token_of_t<execution::env_of_t<R>>;
+    using stop_callback_t =
+        execution::stop_callback_for_t<stop_token_t, stop_requested>;
+
+    Init init;
+    std::tuple<InitArgs...> args;
+    R receiver;
+    boost::asio::cancellation_signal signal{};
+    bool stopped = false;
+    std::optional<stop_callback_t> stop_callback{};
+};
+
+/* The Sender of an asio operation, holding its initiation until started. */
+template <typename Signature, typename Init, typename... InitArgs>
+struct sender;
+
+template <typename... Sig, typename Init, typename... InitArgs>
+struct sender<void(Sig...), Init, InitArgs...>
+{
+    using sender_concept = execution::sender_t;
+
+    template <typename I, typename... As>
+    explicit sender(I&& init, As&&... args) :
+        init(std::forward<I>(init)), args(std::forward<As>(args)...)
+    {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...) ->
+        typename completion<Sig...>::signatures;
+
+    template <execution::receiver R>
+    auto connect(R r) && -> operation<void(Sig...), Init,
+                                      std::tuple<InitArgs...>, R>
+    {
+        return {std::move(init), std::move(args), std::move(r)};
+    }
+
+  private:
+    Init init;
+    std::tuple<InitArgs...> args;
+};
+
+} // namespace sender_ns
+
+} // namespace sdbusplus::asio
+
+template <typename... Sig>
+struct boost::asio::async_result<sdbusplus::asio::use_sender_t, void(Sig...)>
+{
+    template <typename Initiation, typename Token, typename... InitArgs>
+    static auto initiate(Initiation&& init, Token&&, InitArgs&&... args)
+    {
+        return sdbusplus::asio::sender_ns::sender<
+            void(Sig...), std::decay_t<Initiation>,
+            std::decay_t<InitArgs>...>(std::forward<Initiation>(init),
+                                       std::forward<InitArgs>(args)...);
+    }
+};
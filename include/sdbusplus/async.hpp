@@ -2,12 +2,18 @@
 
 // IWYU pragma: begin_exports
 #include <sdbusplus/async/barrier.hpp>
+#include <sdbusplus/async/channel.hpp>
+#include <sdbusplus/async/concurrent.hpp>
 #include <sdbusplus/async/context.hpp>
 #include <sdbusplus/async/execution.hpp>
 #include <sdbusplus/async/fdio.hpp>
+#include <sdbusplus/async/fdio_mux.hpp>
 #include <sdbusplus/async/match.hpp>
 #include <sdbusplus/async/mutex.hpp>
+#include <sdbusplus/async/pooled_task.hpp>
 #include <sdbusplus/async/proxy.hpp>
+#include <sdbusplus/async/semaphore.hpp>
+#include <sdbusplus/async/shared_mutex.hpp>
 #include <sdbusplus/async/task.hpp>
 #include <sdbusplus/async/timer.hpp>
 // IWYU pragma: end_exports
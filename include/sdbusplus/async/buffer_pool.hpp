@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sdbusplus::async
+{
+
+class buffer_pool;
+
+/** A buffer obtained from a buffer_pool, returned to it on destruction.
+ *
+ *  The buffer has a fixed capacity, of which the first `size` bytes hold
+ *  data.
+ */
+class pooled_buffer
+{
+  public:
+    pooled_buffer() = default;
+    pooled_buffer(const pooled_buffer&) = delete;
+    pooled_buffer& operator=(const pooled_buffer&) = delete;
+
+    pooled_buffer(pooled_buffer&& b) noexcept :
+        pool(std::exchange(b.pool, nullptr)), storage(std::move(b.storage)),
+        length(std::exchange(b.length, 0))
+    {}
+
+    pooled_buffer& operator=(pooled_buffer&& b) noexcept
+    {
+        if (&b != this)
+        {
+            release();
+            pool = std::exchange(b.pool, nullptr);
+            storage = std::move(b.storage);
+            length = std::exchange(b.length, 0);
+        }
+        return *this;
+    }
+
+    ~pooled_buffer()
+    {
+        release();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return storage != nullptr;
+    }
+
+    /** The bytes holding data. */
+    std::span<std::byte> data() noexcept
+    {
+        return {storage.get(), length};
+    }
+
+    /** The whole buffer, regardless of `size`. */
+    std::span<std::byte> space() noexcept;
+
+    size_t size() const noexcept
+    {
+        return length;
+    }
+
+    /** Set the number of bytes holding data; at most the capacity. */
+    void resize(size_t n) noexcept
+    {
+        length = n;
+    }
+
+  private:
+    friend buffer_pool;
+
+    pooled_buffer(buffer_pool* pool, std::unique_ptr<std::byte[]>&& storage) :
+        pool(pool), storage(std::move(storage))
+    {}
+
+    void release() noexcept;
+
+    buffer_pool* pool = nullptr;
+    std::unique_ptr<std::byte[]> storage{};
+    size_t length = 0;
+};
+
+/** A pool of equally sized buffers.
+ *
+ *  Buffers are recycled as they are released, so a steady stream of reads
+ *  does not allocate once the pool is warm.  Up to `retain` free buffers are
+ *  kept; buffers released beyond that are freed.  The pool must outlive the
+ *  buffers it hands out.
+ */
+class buffer_pool
+{
+  public:
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+    buffer_pool(buffer_pool&&) = delete;
+    buffer_pool& operator=(buffer_pool&&) = delete;
+    ~buffer_pool() = default;
+
+    explicit buffer_pool(size_t buffer_size, size_t retain = 8) :
+        buffer_size(buffer_size), retain(retain)
+    {
+        free.reserve(retain);
+    }
+
+    /** Get a buffer, allocating one if none are free. */
+    pooled_buffer get()
+    {
+        {
+            std::lock_guard l{lock};
+            if (!free.empty())
+            {
+                auto storage = std::move(free.back());
+                free.pop_back();
+                return {this, std::move(storage)};
+            }
+        }
+
+        return {this, std::make_unique_for_overwrite<std::byte[]>(buffer_size)};
+    }
+
+    size_t capacity() const noexcept
+    {
+        return buffer_size;
+    }
+
+  private:
+    friend pooled_buffer;
+
+    void put(std::unique_ptr<std::byte[]>&& storage) noexcept
+    {
+        std::lock_guard l{lock};
+
+        // Never grows past the reservation, so this does not throw.
+        if (free.size() < retain)
+        {
+            free.emplace_back(std::move(storage));
+        }
+    }
+
+    size_t buffer_size;
+    size_t retain;
+    std::mutex lock{};
+    std::vector<std::unique_ptr<std::byte[]>> free{};
+};
+
+inline std::span<std::byte> pooled_buffer::space() noexcept
+{
+    return {storage.get(), pool ? pool->capacity() : 0};
+}
+
+inline void pooled_buffer::release() noexcept
+{
+    if (storage)
+    {
+        pool->put(std::move(storage));
+        storage.reset();
+    }
+    pool = nullptr;
+    length = 0;
+}
+
+} // namespace sdbusplus::async
@@ -5,6 +5,8 @@
 #include <sdbusplus/async/execution.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <atomic>
+#include <optional>
 #include <type_traits>
 
 namespace sdbusplus::async
@@ -17,7 +19,15 @@ template <typename Fn>
 concept takes_msg_handler =
     std::is_invocable_r_v<int, Fn, sd_bus_message_handler_t, void*>;
 
-template <takes_msg_handler Init>
+template <typename Fn>
+concept takes_msg_handler_slot =
+    std::is_invocable_r_v<int, Fn, sd_bus_slot**, sd_bus_message_handler_t,
+                          void*>;
+
+template <typename Fn>
+concept callback_init = takes_msg_handler<Fn> || takes_msg_handler_slot<Fn>;
+
+template <callback_init Init>
 struct callback_sender;
 
 } // namespace callback_ns
@@ -41,13 +51,26 @@ struct callback_sender;
  *      })
  *  ```
  *
+ *  If the `Init` function also takes a `sd_bus_slot**` as its first
+ *  parameter, the Sender owns the resulting slot: a stop request on the
+ *  Receiver releases the slot, which cancels the pending operation, and the
+ *  Sender completes with `set_stopped`.  Stop requests should come from the
+ *  thread processing the bus, as with any other sd-bus call.
+ *
+ *  ```
+ *      callback([bus = get_busp(ctx),
+ *                msg = std::move(msg)](auto slot, auto cb, auto data) {
+ *          return sd_bus_call_async(bus, slot, msg.get(), cb, data, 0);
+ *      })
+ *  ```
+ *
  *  @param[in] i - A function which calls the underlying sd_bus library
  *                 function.
  *
  *  @returns A Sender which completes when sd-bus calls the callback and yields
  *           a `sdbusplus::message_t`.
  */
-template <callback_ns::takes_msg_handler Init>
+template <callback_ns::callback_init Init>
 auto callback(Init i)
 {
     return callback_ns::callback_sender<Init>(std::move(i));
@@ -57,7 +80,7 @@ namespace callback_ns
 {
 
 /** The operation which handles the Sender completion. */
-template <takes_msg_handler Init, execution::receiver R>
+template <callback_init Init, execution::receiver R>
 struct callback_operation
 {
     callback_operation() = delete;
@@ -67,11 +90,24 @@ struct callback_operation
         init(std::move(init)), receiver(std::move(r))
     {}
 
+    ~callback_operation()
+    {
+        sd_bus_slot_unref(slot);
+    }
+
     // Handle the call from sd-bus by ensuring there were no errors
     // and setting the completion value to the resulting message.
     static int handler(sd_bus_message* m, void* cb, sd_bus_error* e) noexcept
     {
         callback_operation& self = *static_cast<callback_operation*>(cb);
+
+        // A stop request already completed the operation.
+        if (self.completed.exchange(true))
+        {
+            return 0;
+        }
+        self.stop_callback.reset();
+
         try
         {
             // Check 'e' for error.
@@ -103,9 +139,27 @@ struct callback_operation
     // Call the init function upon Sender start.
     void start() noexcept
     {
+        auto token = execution::get_stop_token(execution::get_env(receiver));
+        if constexpr (takes_msg_handler_slot<Init>)
+        {
+            if (token.stop_requested())
+            {
+                execution::set_stopped(std::move(receiver));
+                return;
+            }
+        }
+
         try
         {
-            auto rc = init(handler, this);
+            int rc = 0;
+            if constexpr (takes_msg_handler_slot<Init>)
+            {
+                rc = init(&slot, handler, this);
+            }
+            else
+            {
+                rc = init(handler, this);
+            }
             if (rc < 0)
             {
                 throw exception::SdBusError(-rc, __PRETTY_FUNCTION__);
@@ -114,12 +168,44 @@ struct callback_operation
         catch (...)
         {
             execution::set_error(std::move(receiver), std::current_exception());
+            return;
+        }
+
+        if constexpr (takes_msg_handler_slot<Init>)
+        {
+            stop_callback.emplace(std::move(token), stop_requested{this});
         }
     }
 
   private:
+    // Release the slot, which cancels the sd-bus operation, and complete as
+    // stopped.
+    struct stop_requested
+    {
+        void operator()() noexcept
+        {
+            if (self->completed.exchange(true))
+            {
+                return;
+            }
+
+            sd_bus_slot_unref(std::exchange(self->slot, nullptr));
+            execution::set_stopped(std::move(self->receiver));
+        }
+
+        callback_operation* self;
+    };
+
+    using stop_token_t =
+        execution::stop_token_of_t<execution::env_of_t<R>>;
+    using stop_callback_t =
+        execution::stop_callback_for_t<stop_token_t, stop_requested>;
+
     Init init;
     R receiver;
+    sd_bus_slot* slot = nullptr;
+    std::atomic<bool> completed = false;
+    std::optional<stop_callback_t> stop_callback{};
 };
 
 /** The Sender for a callback.
@@ -128,7 +214,7 @@ struct callback_operation
  *  to (co_awaited on for co-routines), when it is turned into a pending
  *  operation.
  */
-template <takes_msg_handler Init>
+template <callback_init Init>
 struct callback_sender
 {
     using sender_concept = execution::sender_t;
@@ -0,0 +1,555 @@
+#pragma once
+
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/intrusive_queue.hpp>
+#include <sdbusplus/async/ring_buffer.hpp>
+#include <sdbusplus/async/stoppable_operation.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace sdbusplus::async
+{
+
+template <typename T>
+class channel;
+
+namespace channel_ns
+{
+template <typename T>
+struct send_completion;
+template <typename T>
+struct receive_completion;
+} // namespace channel_ns
+
+/** A multi-producer, multi-consumer queue between tasks.
+ *
+ *  Values are passed with the `send` and `receive` Senders.  A bounded
+ *  channel holds at most `capacity` values; `send` then waits for a receiver
+ *  to make room, so a fast producer is slowed to the pace of its consumers.
+ *
+ *  The queue is a ring buffer allocated once, up to `capacity`, and a value
+ *  sent to a waiting receiver is moved to it directly.  Waiting senders keep
+ *  their value, and both senders and receivers are queued, within their own
+ *  operation state.  Waiters are served in order and can be cancelled through
+ *  their stop token.
+ *
+ *  ```
+ *      channel<message_t> decoded{16};
+ *
+ *      // Producer.
+ *      co_await decoded.send(std::move(msg));
+ *
+ *      // Consumer.
+ *      while (!ctx.stop_requested())
+ *      {
+ *          for (auto& msg : co_await decoded.receive_batch(8))
+ *          {
+ *              store(msg);
+ *          }
+ *      }
+ *  ```
+ */
+template <typename T>
+class channel
+{
+  public:
+    channel(const channel&) = delete;
+    channel& operator=(const channel&) = delete;
+    channel(channel&&) = delete;
+    channel& operator=(channel&&) = delete;
+
+    /** Construct the channel, holding up to `capacity` values (0 is
+     *  unbounded). */
+    explicit channel(size_t capacity = 0) : queue(capacity) {}
+
+    ~channel()
+    {
+        close();
+    }
+
+    /** Get the Sender queueing `value`.
+     *
+     *  Completes once the value is queued, or completes as stopped if the
+     *  channel is closed first.
+     */
+    auto send(T value);
+
+    /** Get the Sender for the next value.
+     *
+     *  Completes as stopped once the channel is closed and drained.
+     */
+    auto receive() noexcept;
+
+    /** Get the Sender for the queued values, up to `max`, as a
+     *  `std::vector<T>`.
+     *
+     *  Completes once at least one value is available, or as stopped once
+     *  the channel is closed and drained.
+     */
+    auto receive_batch(size_t max) noexcept;
+
+    /** Queue `value`, if there is room, without waiting.
+     *
+     *  @return true if the value was moved into the channel.
+     */
+    bool try_send(T&& value)
+    {
+        std::unique_lock l{lock};
+        if (closed || (receivers.empty() && queue.full()))
+        {
+            return false;
+        }
+
+        push(std::move(l), std::move(value));
+        return true;
+    }
+
+    /** Take the next value, if any, without waiting. */
+    std::optional<T> try_receive()
+    {
+        std::unique_lock l{lock};
+        if (queue.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto value = queue.pop_front();
+        refill(std::move(l));
+        return value;
+    }
+
+    /** Close the channel.
+     *
+     *  Waiting and later senders complete as stopped, dropping their value.
+     *  Receivers still get the queued values, and then complete as stopped.
+     */
+    void close() noexcept
+    {
+        details::intrusive_queue<channel_ns::send_completion<T>> s{};
+        details::intrusive_queue<channel_ns::receive_completion<T>> r{};
+        {
+            std::lock_guard l{lock};
+            closed = true;
+            std::swap(s, senders);
+            std::swap(r, receivers);
+        }
+
+        while (!s.empty())
+        {
+            dequeued(s.pop_front())->stop();
+        }
+        while (!r.empty())
+        {
+            dequeued(r.pop_front())->stop();
+        }
+    }
+
+    bool is_closed()
+    {
+        std::lock_guard l{lock};
+        return closed;
+    }
+
+    /** The number of queued values. */
+    size_t size()
+    {
+        std::lock_guard l{lock};
+        return queue.size();
+    }
+
+    friend channel_ns::send_completion<T>;
+    friend channel_ns::receive_completion<T>;
+
+  private:
+    /** Hand `value` to a waiting receiver, or queue it.
+     *
+     *  This must be called with `lock` held (and ownership transfers).
+     */
+    void push(std::unique_lock<std::mutex>&& l, T&& value)
+    {
+        auto lock = std::move(l);
+
+        // Receivers only wait while the queue is empty.
+        if (receivers.empty())
+        {
+            queue.push_back(std::move(value));
+            return;
+        }
+
+        auto r = dequeued(receivers.pop_front());
+        lock.unlock();
+
+        if (r->max == 0)
+        {
+            r->complete(std::move(value));
+        }
+        else
+        {
+            std::vector<T> values{};
+            values.emplace_back(std::move(value));
+            r->complete_batch(std::move(values));
+        }
+    }
+
+    /** Move the values of waiting senders into the room made in the queue,
+     *  and complete them.
+     *
+     *  This must be called with `lock` held (and ownership transfers).
+     */
+    void refill(std::unique_lock<std::mutex>&& l)
+    {
+        auto lock = std::move(l);
+
+        details::intrusive_queue<channel_ns::send_completion<T>> done{};
+        while (!senders.empty() && !queue.full())
+        {
+            auto s = dequeued(senders.pop_front());
+            queue.push_back(std::move(s->value));
+            done.push_back(s);
+        }
+
+        lock.unlock();
+
+        // Complete outside of the lock, since the completed tasks may run and
+        // send again.
+        while (!done.empty())
+        {
+            done.pop_front()->complete();
+        }
+    }
+
+    void start_send(channel_ns::send_completion<T>* s) noexcept
+    {
+        std::unique_lock l{lock};
+
+        if (closed)
+        {
+            l.unlock();
+            s->stop();
+            return;
+        }
+
+        if (receivers.empty() && queue.full())
+        {
+            s->queued = true;
+            senders.push_back(s);
+            return;
+        }
+
+        push(std::move(l), std::move(s->value));
+        s->complete();
+    }
+
+    void start_receive(channel_ns::receive_completion<T>* r) noexcept
+    {
+        std::unique_lock l{lock};
+
+        if (queue.empty())
+        {
+            if (closed)
+            {
+                l.unlock();
+                r->stop();
+                return;
+            }
+
+            r->queued = true;
+            receivers.push_back(r);
+            return;
+        }
+
+        if (r->max == 0)
+        {
+            auto value = queue.pop_front();
+            refill(std::move(l));
+            r->complete(std::move(value));
+            return;
+        }
+
+        std::vector<T> values{};
+        values.reserve(std::min(r->max, queue.size()));
+        while ((values.size() < r->max) && !queue.empty())
+        {
+            values.emplace_back(queue.pop_front());
+        }
+        refill(std::move(l));
+        r->complete_batch(std::move(values));
+    }
+
+    /** Remove a waiter from its queue, for a stop request.
+     *
+     *  @return true if the waiter was queued, and must complete as stopped.
+     */
+    template <typename Completion>
+    bool cancel(Completion* c) noexcept
+    {
+        std::lock_guard l{lock};
+        if (!c->queued)
+        {
+            return false;
+        }
+        c->queued = false;
+
+        auto remove = [c](auto& q) {
+            details::intrusive_queue<Completion> removed{};
+            q.extract_if([c](auto& e) { return &e == c; }, removed);
+        };
+
+        if constexpr (std::is_same_v<Completion,
+                                     channel_ns::send_completion<T>>)
+        {
+            remove(senders);
+        }
+        else
+        {
+            remove(receivers);
+        }
+        return true;
+    }
+
+    template <typename Completion>
+    static Completion* dequeued(Completion* c) noexcept
+    {
+        c->queued = false;
+        return c;
+    }
+
+    std::mutex lock{};
+    details::ring_buffer<T> queue;
+    details::intrusive_queue<channel_ns::send_completion<T>> senders{};
+    details::intrusive_queue<channel_ns::receive_completion<T>> receivers{};
+    bool closed = false;
+};
+
+namespace channel_ns
+{
+
+// Virtual class to handle the send Receiver completions.
+template <typename T>
+struct send_completion
+{
+    send_completion() = delete;
+    send_completion(send_completion&&) = delete;
+
+    send_completion(channel<T>& ch, T&& value) :
+        ch(ch), value(std::move(value))
+    {}
+    virtual ~send_completion() = default;
+
+    friend channel<T>;
+    friend details::intrusive_queue<send_completion>;
+
+  protected:
+    void start() noexcept
+    {
+        ch.start_send(this);
+    }
+
+    bool cancel() noexcept
+    {
+        return ch.cancel(this);
+    }
+
+  private:
+    virtual void complete() noexcept = 0;
+    virtual void stop() noexcept = 0;
+
+    channel<T>& ch;
+    T value;
+    send_completion* next = nullptr;
+    bool queued = false;
+};
+
+// Virtual class to handle the receive Receiver completions.
+template <typename T>
+struct receive_completion
+{
+    receive_completion() = delete;
+    receive_completion(receive_completion&&) = delete;
+
+    explicit receive_completion(channel<T>& ch, size_t max = 0) :
+        ch(ch), max(max)
+    {}
+    virtual ~receive_completion() = default;
+
+    friend channel<T>;
+    friend details::intrusive_queue<receive_completion>;
+
+  protected:
+    void start() noexcept
+    {
+        ch.start_receive(this);
+    }
+
+    bool cancel() noexcept
+    {
+        return ch.cancel(this);
+    }
+
+  private:
+    // Called for completions with `max` of 0.
+    virtual void complete(T&&) noexcept {}
+    // Called for completions with a non-zero `max`.
+    virtual void complete_batch(std::vector<T>&&) noexcept {}
+    virtual void stop() noexcept = 0;
+
+    channel<T>& ch;
+    size_t max;
+    receive_completion* next = nullptr;
+    bool queued = false;
+};
+
+// Implementation (templated based on Receiver) of send_completion.
+template <typename T, execution::receiver R>
+struct send_operation :
+    details::stoppable_operation<send_completion<T>, R>
+{
+    send_operation(channel<T>& ch, T&& value, R r) :
+        details::stoppable_operation<send_completion<T>, R>(
+            std::move(r), ch, std::move(value))
+    {}
+
+  private:
+    void complete() noexcept override final
+    {
+        execution::set_value(std::move(this->receiver));
+    }
+};
+
+// Implementation (templated based on Receiver) of receive_completion.
+template <typename T, execution::receiver R>
+struct receive_operation :
+    details::stoppable_operation<receive_completion<T>, R>
+{
+    receive_operation(channel<T>& ch, R r) :
+        details::stoppable_operation<receive_completion<T>, R>(std::move(r),
+                                                               ch)
+    {}
+
+  private:
+    void complete(T&& value) noexcept override final
+    {
+        execution::set_value(std::move(this->receiver), std::move(value));
+    }
+};
+
+// Implementation (templated based on Receiver) of a batch
+// receive_completion.
+template <typename T, execution::receiver R>
+struct receive_batch_operation :
+    details::stoppable_operation<receive_completion<T>, R>
+{
+    receive_batch_operation(channel<T>& ch, size_t max, R r) :
+        details::stoppable_operation<receive_completion<T>, R>(std::move(r),
+                                                               ch, max)
+    {}
+
+  private:
+    void complete_batch(std::vector<T>&& values) noexcept override final
+    {
+        execution::set_value(std::move(this->receiver), std::move(values));
+    }
+};
+
+// channel send Sender implementation.
+template <typename T>
+struct send_sender
+{
+    using sender_concept = execution::sender_t;
+
+    send_sender() = delete;
+    send_sender(channel<T>& ch, T&& value) : ch(ch), value(std::move(value)) {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<execution::set_value_t(),
+                                            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> send_operation<T, R>
+    {
+        return {ch, std::move(value), std::move(r)};
+    }
+
+  private:
+    channel<T>& ch;
+    T value;
+};
+
+// channel receive Sender implementation.
+template <typename T>
+struct receive_sender
+{
+    using sender_concept = execution::sender_t;
+
+    receive_sender() = delete;
+    explicit receive_sender(channel<T>& ch) noexcept : ch(ch) {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<execution::set_value_t(T),
+                                            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> receive_operation<T, R>
+    {
+        return {ch, std::move(r)};
+    }
+
+  private:
+    channel<T>& ch;
+};
+
+// channel batch receive Sender implementation.
+template <typename T>
+struct receive_batch_sender
+{
+    using sender_concept = execution::sender_t;
+
+    receive_batch_sender() = delete;
+    receive_batch_sender(channel<T>& ch, size_t max) noexcept :
+        ch(ch), max(max)
+    {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<
+            execution::set_value_t(std::vector<T>), execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> receive_batch_operation<T, R>
+    {
+        return {ch, max, std::move(r)};
+    }
+
+  private:
+    channel<T>& ch;
+    size_t max;
+};
+
+} // namespace channel_ns
+
+template <typename T>
+auto channel<T>::send(T value)
+{
+    return channel_ns::send_sender<T>(*this, std::move(value));
+}
+
+template <typename T>
+auto channel<T>::receive() noexcept
+{
+    return channel_ns::receive_sender<T>(*this);
+}
+
+template <typename T>
+auto channel<T>::receive_batch(size_t max) noexcept
+{
+    return channel_ns::receive_batch_sender<T>(*this,
+                                               std::max<size_t>(max, 1));
+}
+
+} // namespace sdbusplus::async
@@ -70,6 +70,15 @@ class client :
         return client<S, true, Preserved, Types...>(ctx, proxy.path(p));
     }
 
+    /* Copy of the client whose calls use the given timeout.  This is not
+     * named `timeout`, which would hide any generated member of that name,
+     * such as a property accessor, in the Types. */
+    auto with_call_timeout(std::chrono::microseconds t) const noexcept
+        requires(S || P)
+    {
+        return Self(ctx, proxy.timeout(t));
+    }
+
     /* Convert client into a Preserved Proxy. */
     auto preserve() const noexcept
         requires(!Preserved)
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <sdbusplus/async/context.hpp>
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/task.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sdbusplus::async
+{
+
+/** Run `fn` over the items of `range`, with at most `limit` in flight.
+ *
+ *  `fn` is called with each item and returns a Sender (such as a task or a
+ *  proxy call), whose value is discarded; any handling of the results is done
+ *  by the Senders as they complete.  This bounds the load put on the
+ *  dbus-daemon, and the queue of replies, when querying many objects:
+ *
+ *  ```
+ *      co_await for_each_concurrent(
+ *          ctx, paths, 16, [&](const auto& path) -> task<> {
+ *              auto value = co_await proxy.path(path).get_property<double>(
+ *                  ctx, "Value");
+ *              update(path, value);
+ *          });
+ *  ```
+ *
+ *  The Senders are started, and complete, on the context's thread, in the
+ *  order of the range.  Once one fails, no more are started and those in
+ *  flight are sent a stop request; the first exception is then rethrown.
+ *  If one completes as stopped, or the awaiting task is stopped, the rest
+ *  are likewise stopped and the Sender completes as stopped.
+ *
+ *  The range is referenced, or moved from when it is an rvalue, and its
+ *  items must stay valid until their Senders complete.
+ *
+ *  @param[in] ctx The async context.
+ *  @param[in] range The items; a forward range.
+ *  @param[in] limit The most Senders in flight; at least 1.
+ *  @param[in] fn The function returning the Sender for an item.
+ *
+ *  @return A task which completes once all of the Senders have completed.
+ */
+template <std::ranges::forward_range Range, typename Fn>
+auto for_each_concurrent(context& ctx, Range&& range, size_t limit, Fn fn)
+    -> task<>;
+
+/** Run `fn` over the items of `range`, with at most `limit` in flight, and
+ *  collect the results in the order of the range.
+ *
+ *  This is `for_each_concurrent` for Senders completing with a value, which
+ *  completes with a `std::vector` of the values once all have completed.
+ */
+template <std::ranges::forward_range Range, typename Fn>
+auto when_all_bounded(context& ctx, Range&& range, size_t limit, Fn fn);
+
+namespace concurrent_ns
+{
+
+// Value type of a Sender completing with at most one value.
+template <typename... Ts>
+struct single_value
+{
+    static_assert(sizeof...(Ts) == 1,
+                  "Sender must complete with a single value.");
+};
+
+template <typename T>
+struct single_value<T>
+{
+    using type = std::decay_t<T>;
+};
+
+template <>
+struct single_value<>
+{
+    using type = void;
+};
+
+template <typename... Vs>
+struct single_variant
+{
+    static_assert(sizeof...(Vs) == 1,
+                  "Sender must have a single value completion.");
+};
+
+template <typename V>
+struct single_variant<V>
+{
+    using type = typename V::type;
+};
+
+template <typename S>
+using value_t = typename execution::value_types_of_t<
+    S, execution::env<>, single_value, single_variant>::type;
+
+/* The state of a fan-out, shared by its workers.
+ *
+ * `limit` workers are spawned into a local scope, each repeatedly taking the
+ * next item and awaiting its Sender, until the scope is stopped.  The
+ * workers all run on the context's thread, so the state needs no locking.
+ */
+template <std::ranges::forward_range View, typename Fn, typename R>
+class fan_out : details::context_friend
+{
+  public:
+    fan_out(const fan_out&) = delete;
+    fan_out& operator=(const fan_out&) = delete;
+    fan_out(fan_out&&) = delete;
+    fan_out& operator=(fan_out&&) = delete;
+    ~fan_out() = default;
+
+    fan_out(context& ctx, View&& items, Fn&& fn) :
+        ctx(ctx), items(std::move(items)), fn(std::move(fn)),
+        next(std::ranges::begin(this->items))
+    {}
+
+    auto run(size_t limit) -> task<>
+    {
+        if (limit == 0)
+        {
+            throw std::invalid_argument("Concurrency limit must be positive");
+        }
+
+        auto count = static_cast<size_t>(std::ranges::distance(items));
+        if constexpr (!std::is_void_v<R>)
+        {
+            results.resize(count);
+        }
+
+        // Forward a stop request of the awaiting task to the workers.
+        auto token = co_await execution::read_env(execution::get_stop_token);
+        execution::stop_callback_for_t<decltype(token), stop_requested>
+            forward_stop{token, stop_requested{this}};
+
+        for (size_t i = 0; i < std::min(limit, count); ++i)
+        {
+            scope.spawn(
+                execution::starts_on(get_scheduler(ctx), worker()) |
+                execution::upon_stopped(
+                    [this]() noexcept { scope.request_stop(); }));
+        }
+        co_await scope.on_empty();
+
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+        if (scope.get_stop_token().stop_requested())
+        {
+            co_await execution::just_stopped();
+        }
+    }
+
+    /** Get the results, in the order of the items. */
+    auto take_results()
+    {
+        std::vector<R> values{};
+        values.reserve(results.size());
+        for (auto& r : results)
+        {
+            values.emplace_back(std::move(*r));
+        }
+        return values;
+    }
+
+  private:
+    struct stop_requested
+    {
+        void operator()() noexcept
+        {
+            self->scope.request_stop();
+        }
+
+        fan_out* self;
+    };
+
+    auto worker() -> task<>
+    {
+        while (!scope.get_stop_token().stop_requested() &&
+               (next != std::ranges::end(items)))
+        {
+            auto index = position++;
+            auto&& item = *next++;
+
+            try
+            {
+                // Return to the context's thread, since the Sender may
+                // complete elsewhere.
+                auto s = execution::continues_on(std::invoke(fn, item),
+                                                 get_scheduler(ctx));
+                if constexpr (std::is_void_v<R>)
+                {
+                    co_await std::move(s);
+                }
+                else
+                {
+                    results[index].emplace(co_await std::move(s));
+                }
+            }
+            catch (...)
+            {
+                if (!failure)
+                {
+                    failure = std::current_exception();
+                }
+                scope.request_stop();
+            }
+        }
+    }
+
+    context& ctx;
+    View items;
+    Fn fn;
+    std::ranges::iterator_t<View> next;
+    size_t position = 0;
+
+    std::exception_ptr failure{};
+    std::vector<std::optional<std::conditional_t<std::is_void_v<R>, int, R>>>
+        results{};
+
+    async_scope scope{};
+};
+
+template <typename View, typename Fn>
+auto for_each(context& ctx, View items, size_t limit, Fn fn) -> task<>
+{
+    fan_out<View, Fn, void> f{ctx, std::move(items), std::move(fn)};
+    co_await f.run(limit);
+}
+
+template <typename R, typename View, typename Fn>
+auto collect(context& ctx, View items, size_t limit, Fn fn)
+    -> task<std::vector<R>>
+{
+    fan_out<View, Fn, R> f{ctx, std::move(items), std::move(fn)};
+    co_await f.run(limit);
+    co_return f.take_results();
+}
+
+} // namespace concurrent_ns
+
+template <std::ranges::forward_range Range, typename Fn>
+auto for_each_concurrent(context& ctx, Range&& range, size_t limit, Fn fn)
+    -> task<>
+{
+    // The coroutine takes a view by value, so a temporary range outlives
+    // this call.
+    return concurrent_ns::for_each(ctx,
+                                   std::views::all(std::forward<Range>(range)),
+                                   limit, std::move(fn));
+}
+
+template <std::ranges::forward_range Range, typename Fn>
+auto when_all_bounded(context& ctx, Range&& range, size_t limit, Fn fn)
+{
+    using R = concurrent_ns::value_t<
+        std::invoke_result_t<Fn&, std::ranges::range_reference_t<Range>>>;
+    static_assert(!std::is_void_v<R>,
+                  "Use for_each_concurrent for Senders without a value.");
+
+    return concurrent_ns::collect<R>(
+        ctx, std::views::all(std::forward<Range>(range)), limit,
+        std::move(fn));
+}
+
+} // namespace sdbusplus::async
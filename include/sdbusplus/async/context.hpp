@@ -1,14 +1,22 @@
 #pragma once
 
 #include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/frame_pool.hpp>
+#include <sdbusplus/async/run_loop.hpp>
 #include <sdbusplus/async/task.hpp>
+#include <sdbusplus/async/timer_wheel.hpp>
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/event.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <stop_token>
 #include <thread>
+#include <vector>
 
 namespace sdbusplus::async
 {
@@ -16,10 +24,82 @@ namespace sdbusplus::async
 namespace details
 {
 struct wait_process_completion;
+struct attached_bus;
 struct context_friend;
 
 } // namespace details
 
+/** @brief Options for a context. */
+struct context_options
+{
+    /** Run the sd-event loop, sd-bus processing and all tasks on the thread
+     *  which calls `run`, rather than handing tasks to a worker thread.
+     *
+     *  This removes the thread hand-off from every dbus message, but a task
+     *  which blocks also blocks all dbus processing.
+     */
+    bool single_thread = false;
+
+    /** The most dbus messages to process each time the bus is woken, before
+     *  letting other tasks run.  Must be at least 1. */
+    size_t process_batch = 16;
+
+    /** The most free coroutine frames to keep per size class, for reuse by
+     *  the `pooled_task`s created on the context's threads.  0 disables the
+     *  pooling of frames. */
+    size_t frame_pool_retain = 64;
+
+    /** The most tasks run from higher priorities while a lower priority task
+     *  is ready, before the lower priority task runs.  Must be at least 1.
+     */
+    size_t starvation_limit = 16;
+
+    /** An sd_event to share, such as the default event of the thread (see
+     *  sd_event_default), rather than creating one.  Sources added to it by
+     *  other code, such as an `sdbusplus::Timer` or a bus attached with
+     *  sd_bus_attach_event, are then dispatched by the context's `run`.
+     *  The context holds a reference on the sd_event. */
+    sd_event* event = nullptr;
+};
+
+/** @brief Counters describing the load of a context.
+ *
+ *  Rates, such as wakeups per second, are obtained by sampling the counters
+ *  periodically; the busy fraction of the thread running the tasks is the
+ *  change in `busy_time` over the time between two samples.
+ */
+struct context_stats
+{
+    /** Number of times the bus was woken to process messages. */
+    uint64_t wakeups = 0;
+    /** Number of dbus messages processed. */
+    uint64_t messages = 0;
+    /** Most messages processed by a single wakeup. */
+    uint64_t max_messages_per_wakeup = 0;
+
+    /** Number of tasks run, counting each resumption of a task. */
+    uint64_t tasks_run = 0;
+    /** Total time the tasks waited to run, once ready. */
+    std::chrono::nanoseconds scheduling_lag{};
+    /** Longest time a task waited to run, once ready. */
+    std::chrono::nanoseconds max_scheduling_lag{};
+    /** Total time spent running the tasks. */
+    std::chrono::nanoseconds busy_time{};
+
+    /** Number of sd-event loop iterations which dispatched events. */
+    uint64_t event_dispatches = 0;
+    /** Total time spent dispatching sd-events. */
+    std::chrono::nanoseconds event_dispatch_time{};
+    /** Longest time spent dispatching the sd-events of an iteration. */
+    std::chrono::nanoseconds max_event_dispatch_time{};
+
+    /** Number of spawned Senders which have not completed. */
+    size_t pending_tasks = 0;
+    /** Number of the context's own tasks, such as the dbus processing and
+     *  the watchdog, which have not completed. */
+    size_t internal_tasks = 0;
+};
+
 /** @brief A run-loop context for handling asynchronous dbus operations.
  *
  *  This class encapsulates the run-loop for asynchronous operations,
@@ -37,11 +117,31 @@ struct context_friend;
  *  thread which called `sd_bus_wait`, but the `worker` is where all
  *  `sd_bus_process` calls are performed.  There is a condition-variable based
  *  handshake between the two threads to accomplish this interaction.
+ *
+ *  With `context_options::single_thread`, there is no worker thread: the
+ *  `caller` alternates between running the ready tasks and waiting on the
+ *  sd-events, and performs the `sd_bus_process` calls itself.
+ *
+ *  Further buses, such as a peer-to-peer or private bus alongside the
+ *  system bus, can be added with `attach_bus`; they share the threads and
+ *  run-loop of the context.
+ *
+ *  Tasks are spawned at a `priority`.  The dbus processing and the watchdog
+ *  run at `priority::high`, so a burst of ordinary tasks does not delay
+ *  them; a bulk task can be spawned at `priority::low` to stay out of the
+ *  way of the rest.
+ *
+ *  A context can share an sd_event with code that predates it, through
+ *  `context_options::event`, so that a single loop dispatches everything.
+ *  The sd-event callbacks run on the thread calling `run`, and that code
+ *  must only use the sd_event from there; with `single_thread`, the tasks
+ *  run on that thread too.
  */
 class context : public sdbusplus::details::bus_friend
 {
   public:
-    explicit context(bus_t&& bus = bus_t::new_bus());
+    explicit context(bus_t&& bus = bus_t::new_bus(),
+                     context_options options = {});
     context(context&&) = delete;
     context(const context&) = delete;
 
@@ -56,14 +156,16 @@ class context : public sdbusplus::details::bus_friend
     /** Spawn a Sender to run on the context.
      *
      * @param[in] sender - The Sender to run.
+     * @param[in] prio - The priority to run the Sender at.
      */
     template <typename Snd>
-    void spawn(Snd&& sender)
+    void spawn(Snd&& sender, priority prio = priority::normal)
     {
         check_stop_requested();
 
-        pending_tasks.spawn(std::move(
-            execution::starts_on(loop.get_scheduler(), std::move(sender))));
+        pending_tasks.spawn(counted(
+            live_pending, execution::starts_on(loop.get_scheduler(prio),
+                                               std::move(sender))));
 
         spawn_watcher();
     }
@@ -74,13 +176,50 @@ class context : public sdbusplus::details::bus_friend
      * a typical use case.
      *
      * @param[in] t - The task to run.
+     * @param[in] prio - The priority to run the task at.
      */
-    void spawn(task<void>&& t);
+    void spawn(task<void>&& t, priority prio = priority::normal);
+
+    /** Get the scheduler of the context's tasks, at a priority.
+     *
+     *  `execution::starts_on` with the scheduler runs a Sender at that
+     *  priority, and a task can `co_await execution::schedule(...)` to
+     *  change its own.  A task keeps its priority across `sleep_for` and the
+     *  other waits which resume it through the context's scheduler; a task
+     *  resumed by a dbus message, such as a method reply, continues at the
+     *  normal priority.
+     */
+    auto get_scheduler(priority prio = priority::normal) noexcept
+    {
+        return loop.get_scheduler(prio);
+    }
 
     bus_t& get_bus() noexcept
     {
         return bus;
     }
+
+    /** Attach another bus to the context.
+     *
+     *  The bus gets its own sd-event source, but is processed by the same
+     *  worker and run-loop as the primary bus.  Proxies, matches and servers
+     *  default to the primary bus and are bound to an attached bus through
+     *  `proxy::on_bus`, `match_options::bus` or the bus argument of the
+     *  server constructor.
+     *
+     *  @param[in] b - The bus to attach.
+     *
+     *  @return The attached bus, which lives as long as the context.
+     */
+    bus_t& attach_bus(bus_t&& b);
+
+    /** Get the sd_event run by the context, for other code to add sources
+     *  to; see `context_options::event`. */
+    sd_event* get_event() noexcept
+    {
+        return event_loop.get();
+    }
+
     operator bus_t&() noexcept
     {
         return bus;
@@ -101,17 +240,34 @@ class context : public sdbusplus::details::bus_friend
         return initial_stop.stop_requested();
     }
 
+    /** Get the load counters; safe to call from any thread. */
+    context_stats get_stats() const noexcept;
+
+    /** Get the coroutine frame pool counters; safe to call from any thread.
+     */
+    frame_pool_stats get_frame_stats() const noexcept
+    {
+        return frames ? frames->get_stats() : frame_pool_stats{};
+    }
+
     friend details::wait_process_completion;
+    friend details::attached_bus;
     friend details::context_friend;
 
   private:
     bus_t bus;
+    context_options options;
+    /** The pool of the pooled_task frames created on the context's threads.
+     */
+    details::frame_pool::handle frames;
     event_source_t dbus_source;
-    event_t event_loop{};
+    event_t event_loop;
+    /** The timers of `sleep_for`, sharing one sd-event timer. */
+    details::timer_wheel timers{event_loop};
     bool name_requested = false;
 
-    /** The async run-loop from std::execution. */
-    execution::run_loop loop{};
+    /** The async run-loop. */
+    details::run_loop loop;
     /** The worker thread to handle async tasks. */
     std::thread worker_thread{};
     /** Stop source */
@@ -135,6 +291,39 @@ class context : public sdbusplus::details::bus_friend
     details::wait_process_completion* pending = nullptr;
     bool wait_process_stopped = false;
 
+    /** The buses added by `attach_bus`. */
+    std::vector<std::unique_ptr<details::attached_bus>> attached_buses{};
+    /** Wake the attached buses, for them to observe the final stop. */
+    void stop_attached_buses();
+
+
+    // Counters for `get_stats`.
+    std::atomic<uint64_t> stat_wakeups{0};
+    std::atomic<uint64_t> stat_messages{0};
+    std::atomic<uint64_t> stat_max_batch{0};
+    std::atomic<size_t> live_pending{0};
+    std::atomic<size_t> live_internal{0};
+
+    /** Count a spawned Sender in `count` until it completes. */
+    template <typename Snd>
+    static auto counted(std::atomic<size_t>& count, Snd&& sender)
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+        auto done = [&count]() noexcept {
+            count.fetch_sub(1, std::memory_order_relaxed);
+        };
+        return std::forward<Snd>(sender) | execution::then(done) |
+               execution::upon_stopped(done);
+    }
+
+    /** Spawn one of the context's own tasks onto `internal_tasks`. */
+    template <typename Snd>
+    void spawn_internal(Snd&& sender)
+    {
+        internal_tasks.spawn(
+            counted(live_internal, std::forward<Snd>(sender)));
+    }
+
     void worker_run();
     void spawn_complete();
     void check_stop_requested();
@@ -143,6 +332,15 @@ class context : public sdbusplus::details::bus_friend
     void caller_run();
     void wait_for_wait_process_stopped();
 
+    /** Whether the single-thread loop has started the internal tasks. */
+    bool single_started = false;
+    /** The thread running the single-thread loop. */
+    std::atomic<std::thread::id> single_thread_id{};
+
+    void single_run();
+    template <typename Done>
+    void single_run_until(Done&& done);
+
     static int dbus_event_handle(sd_event_source*, int, uint32_t, void*);
 };
 
@@ -174,9 +372,16 @@ struct context_friend
         return ctx.event_loop;
     }
 
+    static timer_wheel& get_timer_wheel(context& ctx)
+    {
+        return ctx.timers;
+    }
+
+    /** Get the scheduler at the priority of the calling task, for a
+     *  wait to resume the task at its priority. */
     static auto get_scheduler(context& ctx)
     {
-        return ctx.loop.get_scheduler();
+        return ctx.loop.get_scheduler(details::run_loop::current_priority());
     }
 };
 } // namespace details
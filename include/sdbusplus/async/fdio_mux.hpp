@@ -0,0 +1,362 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <sdbusplus/async/buffer_pool.hpp>
+#include <sdbusplus/async/context.hpp>
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/intrusive_queue.hpp>
+#include <sdbusplus/async/stoppable_operation.hpp>
+#include <sdbusplus/event.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sdbusplus::async
+{
+
+namespace fdio_mux_ns
+{
+struct io_completion;
+}
+
+/** Reads and writes over any number of non-blocking file descriptors.
+ *
+ *  Unlike `fdio`, which reports readiness of one fd and leaves the I/O to
+ *  the caller, the Senders of this class perform the I/O and complete with
+ *  its result:
+ *      - `async_read_some`: read what is available, at least one byte (or 0
+ *        at end-of-file), into a buffer, a scatter list or a pooled buffer.
+ *      - `async_read_exact`: fill a buffer, failing with
+ *        `fdio_eof_exception` at end-of-file.
+ *      - `async_write_all`: write all of a buffer or a gather list.
+ *
+ *  Each fd is registered once, edge-triggered, for both input and output.
+ *  The I/O is attempted as soon as the Sender starts, and only waits (in
+ *  order, per fd and direction) once the fd would block; the readiness
+ *  notifications then resume the waiters, without re-registering the fd or
+ *  taking the run-loop lock.
+ *
+ *  The Senders complete on the context's scheduler.  A waiting Sender
+ *  completes as stopped on a stop request, or when its fd is removed.
+ */
+class fdio_mux : private context_ref, details::context_friend
+{
+  public:
+    fdio_mux() = delete;
+    fdio_mux(const fdio_mux&) = delete;
+    fdio_mux& operator=(const fdio_mux&) = delete;
+    fdio_mux(fdio_mux&&) = delete;
+    fdio_mux& operator=(fdio_mux&&) = delete;
+    ~fdio_mux();
+
+    explicit fdio_mux(context& ctx);
+
+    /** Start handling the I/O of `fd`, which must be non-blocking. */
+    void add(int fd);
+    /** Stop handling the I/O of `fd`; it is not closed. */
+    void remove(int fd);
+
+    auto async_read_some(int fd, std::span<std::byte> buffer);
+    auto async_read_some(int fd, std::span<const iovec> buffers);
+    /** Read into a buffer from `pool`, which is only taken once data is
+     *  available, and complete with it. */
+    auto async_read_some(int fd, buffer_pool& pool);
+    auto async_read_exact(int fd, std::span<std::byte> buffer);
+    auto async_write_all(int fd, std::span<const std::byte> buffer);
+    auto async_write_all(int fd, std::span<const iovec> buffers);
+
+    friend fdio_mux_ns::io_completion;
+
+  private:
+    struct watch
+    {
+        fdio_mux* mux;
+        int fd;
+
+        /** Whether the fd may be ready; cleared when the I/O would block
+         *  and set again by the readiness notification. */
+        bool readable = true;
+        bool writable = true;
+
+        details::intrusive_queue<fdio_mux_ns::io_completion> readers{};
+        details::intrusive_queue<fdio_mux_ns::io_completion> writers{};
+
+        // Destroyed first, waiting for a running notification to finish.
+        event_source_t source{};
+    };
+
+    template <typename State>
+    auto make_sender(int fd, State&& state);
+
+    void start_io(fdio_mux_ns::io_completion* c) noexcept;
+    bool cancel(fdio_mux_ns::io_completion* c) noexcept;
+
+    static int handler(sd_event_source*, int, uint32_t revents,
+                       void* data) noexcept;
+    void handle_event(watch& w, uint32_t revents) noexcept;
+
+    std::mutex lock{};
+    std::map<int, std::unique_ptr<watch>> watches{};
+};
+
+class fdio_eof_exception : public std::runtime_error
+{
+  public:
+    fdio_eof_exception() : std::runtime_error("End of file") {}
+};
+
+namespace fdio_mux_ns
+{
+
+// Virtual class to handle the I/O Receiver completions.
+struct io_completion
+{
+    io_completion() = delete;
+    io_completion(io_completion&&) = delete;
+
+    io_completion(fdio_mux& mux, int fd, bool write) :
+        mux(mux), fd(fd), write(write)
+    {}
+    virtual ~io_completion() = default;
+
+    friend fdio_mux;
+    friend details::intrusive_queue<io_completion>;
+
+  protected:
+    void start() noexcept
+    {
+        mux.start_io(this);
+    }
+
+    bool cancel() noexcept
+    {
+        return mux.cancel(this);
+    }
+
+  private:
+    /** Attempt the I/O, returning false once it would block.  Throws on
+     *  errors. */
+    virtual bool perform(int fd) = 0;
+    virtual void complete() noexcept = 0;
+    virtual void error(std::exception_ptr exceptionPtr) noexcept = 0;
+    virtual void stop() noexcept = 0;
+
+    fdio_mux& mux;
+    int fd;
+    bool write;
+    io_completion* next = nullptr;
+    bool queued = false;
+    std::exception_ptr failure{};
+};
+
+/* The I/O states, performing the system calls.
+ *
+ * Each provides `perform(fd)`, returning false once the fd would block, and
+ * `result()`, the value completed with.
+ */
+
+struct read_some_state
+{
+    static constexpr bool write = false;
+
+    bool perform(int fd);
+    size_t result() noexcept
+    {
+        return count;
+    }
+
+    std::span<std::byte> buffer;
+    size_t count = 0;
+};
+
+struct readv_some_state
+{
+    static constexpr bool write = false;
+
+    bool perform(int fd);
+    size_t result() noexcept
+    {
+        return count;
+    }
+
+    std::span<const iovec> buffers;
+    size_t count = 0;
+};
+
+struct read_pooled_state
+{
+    static constexpr bool write = false;
+
+    bool perform(int fd);
+    pooled_buffer result() noexcept
+    {
+        return std::move(buffer);
+    }
+
+    buffer_pool* pool;
+    pooled_buffer buffer{};
+};
+
+struct read_exact_state
+{
+    static constexpr bool write = false;
+
+    bool perform(int fd);
+    void result() noexcept {}
+
+    std::span<std::byte> buffer;
+    size_t done = 0;
+};
+
+struct write_all_state
+{
+    static constexpr bool write = true;
+
+    bool perform(int fd);
+    void result() noexcept {}
+
+    std::span<const std::byte> buffer;
+    size_t done = 0;
+};
+
+struct writev_all_state
+{
+    static constexpr bool write = true;
+
+    bool perform(int fd);
+    void result() noexcept {}
+
+    std::span<const iovec> buffers;
+    /** The iovec being written, and the bytes of it already written. */
+    size_t index = 0;
+    size_t offset = 0;
+};
+
+// Implementation (templated based on State and Receiver) of io_completion.
+template <typename State, execution::receiver R>
+struct io_operation : details::stoppable_operation<io_completion, R>
+{
+    io_operation(fdio_mux& mux, int fd, State&& state, R r) :
+        details::stoppable_operation<io_completion, R>(std::move(r), mux, fd,
+                                                       State::write),
+        state(std::move(state))
+    {}
+
+  private:
+    bool perform(int fd) override final
+    {
+        return state.perform(fd);
+    }
+
+    void complete() noexcept override final
+    {
+        if constexpr (std::is_void_v<decltype(state.result())>)
+        {
+            execution::set_value(std::move(this->receiver));
+        }
+        else
+        {
+            execution::set_value(std::move(this->receiver), state.result());
+        }
+    }
+
+    void error(std::exception_ptr exceptionPtr) noexcept override final
+    {
+        execution::set_error(std::move(this->receiver), exceptionPtr);
+    }
+
+    State state;
+};
+
+template <typename T>
+struct value_signature
+{
+    using type = execution::set_value_t(T);
+};
+
+template <>
+struct value_signature<void>
+{
+    using type = execution::set_value_t();
+};
+
+// I/O Sender implementation.
+template <typename State>
+struct io_sender
+{
+    using sender_concept = execution::sender_t;
+
+    io_sender() = delete;
+    io_sender(fdio_mux& mux, int fd, State&& state) noexcept :
+        mux(mux), fd(fd), state(std::move(state))
+    {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<
+            typename value_signature<
+                decltype(std::declval<State&>().result())>::type,
+            execution::set_error_t(std::exception_ptr),
+            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> io_operation<State, R>
+    {
+        return {mux, fd, std::move(state), std::move(r)};
+    }
+
+  private:
+    fdio_mux& mux;
+    int fd;
+    State state;
+};
+
+} // namespace fdio_mux_ns
+
+template <typename State>
+auto fdio_mux::make_sender(int fd, State&& state)
+{
+    // The I/O completes on the sd-event thread when it had to wait, so
+    // switch back to the worker thread.
+    return execution::continues_on(
+        fdio_mux_ns::io_sender<State>(*this, fd, std::move(state)),
+        get_scheduler(ctx));
+}
+
+inline auto fdio_mux::async_read_some(int fd, std::span<std::byte> buffer)
+{
+    return make_sender(fd, fdio_mux_ns::read_some_state{buffer});
+}
+
+inline auto fdio_mux::async_read_some(int fd, std::span<const iovec> buffers)
+{
+    return make_sender(fd, fdio_mux_ns::readv_some_state{buffers});
+}
+
+inline auto fdio_mux::async_read_some(int fd, buffer_pool& pool)
+{
+    return make_sender(fd, fdio_mux_ns::read_pooled_state{&pool});
+}
+
+inline auto fdio_mux::async_read_exact(int fd, std::span<std::byte> buffer)
+{
+    return make_sender(fd, fdio_mux_ns::read_exact_state{buffer});
+}
+
+inline auto fdio_mux::async_write_all(int fd, std::span<const std::byte> buffer)
+{
+    return make_sender(fd, fdio_mux_ns::write_all_state{buffer});
+}
+
+inline auto fdio_mux::async_write_all(int fd, std::span<const iovec> buffers)
+{
+    return make_sender(fd, fdio_mux_ns::writev_all_state{buffers});
+}
+
+} // namespace sdbusplus::async
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace sdbusplus::async
+{
+
+/** Counters describing the coroutine frame pool of a context. */
+struct frame_pool_stats
+{
+    /** Frames allocated by the context's threads. */
+    uint64_t allocations = 0;
+    /** Allocations served from the pool, rather than the heap. */
+    uint64_t reused = 0;
+    /** Allocations too large for the pool's size classes. */
+    uint64_t oversized = 0;
+    /** Frames currently allocated from the pool. */
+    size_t in_use = 0;
+    /** Free frames held by the pool. */
+    size_t cached = 0;
+};
+
+namespace details
+{
+
+/** A pool of coroutine frames, by size class.
+ *
+ *  The frames of the `pooled_task`s created on a thread which has a current
+ *  pool (see `frame_pool::use`) are allocated from it, and recycled rather
+ *  than freed, so a server handling a steady stream of requests does not
+ *  allocate once the pool is warm.
+ *
+ *  The pool belongs to the thread using it; frames freed there are pooled
+ *  directly, while frames freed on other threads are handed back through a
+ *  lock-free list.  Up to `retain` free frames are kept per size class.  The
+ *  pool is freed once its owner and all of its frames have released it.
+ */
+class frame_pool
+{
+  public:
+    /** The size classes, in multiples of `granularity`; larger frames are
+     *  allocated from the heap. */
+    static constexpr size_t granularity = 64;
+    static constexpr size_t classes = 32;
+
+    frame_pool(const frame_pool&) = delete;
+    frame_pool& operator=(const frame_pool&) = delete;
+    frame_pool(frame_pool&&) = delete;
+    frame_pool& operator=(frame_pool&&) = delete;
+
+    struct releaser
+    {
+        void operator()(frame_pool* pool) const noexcept
+        {
+            pool->release();
+        }
+    };
+    using handle = std::unique_ptr<frame_pool, releaser>;
+
+    /** Create a pool, keeping up to `retain` free frames per size class. */
+    static handle create(size_t retain);
+
+    /** Allocate a coroutine frame, from the pool of the calling thread if
+     *  any. */
+    static void* allocate(size_t size);
+    /** Free a frame from `allocate`. */
+    static void deallocate(void* p, size_t size) noexcept;
+
+    frame_pool_stats get_stats() const noexcept;
+
+    /** Make a pool the current pool of the calling thread, while in scope.
+     */
+    class use
+    {
+      public:
+        use(const use&) = delete;
+        use& operator=(const use&) = delete;
+
+        explicit use(frame_pool* pool) noexcept;
+        ~use();
+
+      private:
+        frame_pool* previous;
+    };
+
+  private:
+    struct block;
+
+    explicit frame_pool(size_t retain) noexcept : retain(retain) {}
+    ~frame_pool();
+
+    /** Release the owner's reference. */
+    void release() noexcept;
+
+    void* take(size_t index);
+    void give(block* b) noexcept;
+    void reclaim() noexcept;
+    void unref() noexcept;
+
+    static thread_local frame_pool* current;
+
+    size_t retain;
+
+    /** Free frames by size class, only used by the owning thread. */
+    std::array<block*, classes> free{};
+    std::array<size_t, classes> counts{};
+
+    /** Frames freed by other threads, awaiting the owning thread. */
+    std::atomic<block*> remote{nullptr};
+
+    /** The owner's reference, plus one per frame in use. */
+    std::atomic<size_t> references{1};
+
+    // Counters for `get_stats`, only updated by the owning thread.
+    std::atomic<uint64_t> stat_allocations{0};
+    std::atomic<uint64_t> stat_reused{0};
+    std::atomic<uint64_t> stat_oversized{0};
+    std::atomic<size_t> stat_cached{0};
+};
+
+} // namespace details
+
+} // namespace sdbusplus::async
@@ -0,0 +1,88 @@
+#pragma once
+
+namespace sdbusplus::async::details
+{
+
+/** A FIFO queue of elements linked through their own `next` pointer.
+ *
+ *  The queue never allocates; the elements are typically the operation
+ *  states of waiting senders, which live until they are completed.
+ */
+template <typename T>
+class intrusive_queue
+{
+  public:
+    bool empty() const noexcept
+    {
+        return head == nullptr;
+    }
+
+    T* front() const noexcept
+    {
+        return head;
+    }
+
+    void push_back(T* element) noexcept
+    {
+        element->next = nullptr;
+        if (tail == nullptr)
+        {
+            head = element;
+        }
+        else
+        {
+            tail->next = element;
+        }
+        tail = element;
+    }
+
+    T* pop_front() noexcept
+    {
+        auto element = head;
+        head = element->next;
+        if (head == nullptr)
+        {
+            tail = nullptr;
+        }
+        element->next = nullptr;
+        return element;
+    }
+
+    /** Remove the elements matching `pred`, appending them to `out`. */
+    template <typename Pred>
+    void extract_if(Pred&& pred, intrusive_queue& out) noexcept
+    {
+        T* prev = nullptr;
+        for (auto e = head; e != nullptr;)
+        {
+            auto next = e->next;
+            if (pred(*e))
+            {
+                if (prev == nullptr)
+                {
+                    head = next;
+                }
+                else
+                {
+                    prev->next = next;
+                }
+                if (tail == e)
+                {
+                    tail = prev;
+                }
+                out.push_back(e);
+            }
+            else
+            {
+                prev = e;
+            }
+            e = next;
+        }
+    }
+
+  private:
+    T* head = nullptr;
+    T* tail = nullptr;
+};
+
+} // namespace sdbusplus::async::details
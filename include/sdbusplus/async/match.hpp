@@ -1,14 +1,23 @@
 #pragma once
 #include <sdbusplus/async/context.hpp>
 #include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/ring_buffer.hpp>
+#include <sdbusplus/async/stoppable_operation.hpp>
 #include <sdbusplus/bus/match.hpp> // IWYU pragma: export
+#include <sdbusplus/bus/match_mux.hpp>
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/slot.hpp>
 
+#include <algorithm>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace sdbusplus::async
 {
@@ -17,10 +26,89 @@ namespace match_ns
 struct match_completion;
 }
 
+/** What a bounded match does with a signal arriving while its queue is full.
+ *
+ *  Every policy loses signals: D-Bus signals cannot be back-pressured, as
+ *  the sender neither waits for nor hears of their consumption.  The
+ *  overflow is handled by the match alone: the processing of the bus is
+ *  never paused for it.  The bus is shared with the other matches, the
+ *  method calls of servers and the replies to proxy calls, so pausing it for
+ *  one slow consumer would stall all of them, and deadlock a consumer which
+ *  awaits a D-Bus call while its queue is full.
+ */
+enum class match_overflow
+{
+    /** Discard every arriving signal until the consumer has emptied the
+     *  queue.  The consumer sees a contiguous run of signals, then a single
+     *  gap. */
+    drop_until_drained,
+    /** Discard the oldest queued signal to make room. */
+    drop_oldest,
+    /** Discard the arriving signal. */
+    drop_newest,
+};
+
+/** Options for a match. */
+struct match_options
+{
+    /** Maximum number of signals queued for the consumer; 0 is unbounded. */
+    size_t capacity = 0;
+    /** Handling of signals arriving while `capacity` are queued. */
+    match_overflow overflow = match_overflow::drop_oldest;
+    /** Key of a signal, for coalescing.
+     *
+     *  If set, a signal arriving while another with the same key is queued
+     *  replaces it, in place, so the consumer only sees the latest signal
+     *  per key and its work is bounded by the number of keys.  Since whole
+     *  signals are replaced, keys should identify the state a signal carries
+     *  in full: for PropertiesChanged, an earlier signal for other
+     *  properties of the same interface is lost.  See `match_key`.
+     *
+     *  The read position of the message is reset after the call.
+     */
+    std::function<std::string(message_t&)> coalesce{};
+    /** Register the rule through the bus' match_mux, sharing the
+     *  dbus-daemon registration with other shared matches. */
+    bool shared = false;
+    /** The bus to match on, if not the primary bus of the context; it must
+     *  be attached to the context (see `context::attach_bus`). */
+    bus_t* bus = nullptr;
+};
+
+/** Common coalescing keys for `match_options::coalesce`. */
+namespace match_key
+{
+
+/** Key a signal on its object path. */
+std::string path(message_t& m);
+
+/** Key a PropertiesChanged signal on its object path and interface. */
+std::string properties_changed(message_t& m);
+
+} // namespace match_key
+
+/** Counters describing the queue of a match. */
+struct match_stats
+{
+    /** Signals received from the bus. */
+    uint64_t received = 0;
+    /** Signals discarded by the drop_oldest / drop_newest policies. */
+    uint64_t dropped = 0;
+    /** Signals discarded by the drop_until_drained policy. */
+    uint64_t refused = 0;
+    /** Signals which replaced a queued signal with the same key. */
+    uint64_t coalesced = 0;
+    /** Signals currently queued. */
+    size_t queued = 0;
+    /** Highest value `queued` has reached. */
+    size_t peak_queued = 0;
+};
+
 /** Generator of dbus match Senders.
  *
  *  This class registers a signal match pattern with the dbus and generates
- *  Senders using `next` to await the next matching signal.
+ *  Senders using `next` to await the next matching signal.  A waiting
+ *  Sender completes as stopped on a stop request.
  */
 class match : private sdbusplus::details::bus_friend
 {
@@ -34,7 +122,8 @@ class match : private sdbusplus::details::bus_friend
 
     /** Construct the match using the `pattern` string on the bus managed by the
      *  context. */
-    match(context& ctx, const std::string_view& pattern);
+    match(context& ctx, const std::string_view& pattern,
+          const match_options& options = {});
 
     /** Get the Sender for the next event (as message).
      *
@@ -52,14 +141,47 @@ class match : private sdbusplus::details::bus_friend
     template <typename... Rs>
     auto next() noexcept;
 
+    /** Get the Sender for all of the queued events, up to `max`, as a
+     *  `std::vector<message_t>`.
+     *
+     *  The Sender completes once at least one event is queued, so that a
+     *  consumer which falls behind handles the backlog with one completion
+     *  rather than one per event.  The same single-awaiter restriction as
+     *  `next` applies.
+     */
+    auto next_batch(size_t max) noexcept;
+
+    /** Get the queue counters. */
+    match_stats get_stats();
+
     friend match_ns::match_completion;
 
   private:
+    match_options options;
     sdbusplus::slot_t slot;
+    bus::match_mux::subscription subscription;
 
     std::mutex lock{};
-    std::queue<sdbusplus::message_t> queue{};
+    details::ring_buffer<sdbusplus::message_t> queue;
     match_ns::match_completion* complete = nullptr;
+    match_stats stats{};
+    /** Whether the drop_until_drained policy is refusing signals, until
+     *  the queue is emptied. */
+    bool refusing = false;
+
+    /** Keys of the queued signals, when coalescing. */
+    details::ring_buffer<std::optional<std::string>> keys{};
+    /** Position of the queued signal for each key, counted from the first
+     *  signal ever queued. */
+    std::unordered_map<std::string, uint64_t> keyed{};
+    /** Number of signals removed from the queue. */
+    uint64_t popped = 0;
+
+    /** Remove the oldest signal from the queue.
+     *
+     *  This must be called with `lock` held.
+     */
+    message_t pop();
 
     /** Handle an incoming match event. */
     void handle_match(message_t&&) noexcept;
@@ -70,7 +192,16 @@ class match : private sdbusplus::details::bus_friend
      */
     void handle_completion(std::unique_lock<std::mutex>&&) noexcept;
 
-    slot_t makeMatch(context& ctx, const std::string_view& pattern);
+    /** Accept signals again, once the drop_until_drained policy has
+     *  refused some and the queue has been emptied.
+     *
+     *  This must be called with `lock` held.
+     */
+    void check_drained() noexcept;
+
+    slot_t makeMatch(bus_t& bus, const std::string_view& pattern);
+    bus::match_mux::subscription makeShared(bus_t& bus,
+                                            const std::string_view& pattern);
 };
 
 namespace match_ns
@@ -81,40 +212,59 @@ struct match_completion
     match_completion() = delete;
     match_completion(match_completion&&) = delete;
 
-    explicit match_completion(match& m) : m(m) {};
+    explicit match_completion(match& m, size_t max = 0) : m(m), max(max) {};
     virtual ~match_completion() = default;
 
     friend match;
 
+  protected:
     void start() noexcept;
+    /** Stop awaiting, returning whether this was still the awaiter. */
+    bool cancel() noexcept;
 
   private:
-    virtual void complete(message_t&&) noexcept = 0;
+    // Called for completions with `max` of 0.
+    virtual void complete(message_t&&) noexcept {}
+    // Called for completions with a non-zero `max`.
+    virtual void complete_batch(std::vector<message_t>&&) noexcept {}
     virtual void stop() noexcept = 0;
 
     match& m;
+    size_t max;
 };
 
 // Implementation (templated based on Receiver) of match_completion.
 template <execution::receiver Receiver>
-struct match_operation : match_completion
+struct match_operation :
+    details::stoppable_operation<match_completion, Receiver>
 {
     match_operation(match& m, Receiver r) :
-        match_completion(m), receiver(std::move(r))
+        details::stoppable_operation<match_completion, Receiver>(std::move(r),
+                                                                 m)
     {}
 
   private:
     void complete(message_t&& msg) noexcept override final
     {
-        execution::set_value(std::move(receiver), std::move(msg));
+        execution::set_value(std::move(this->receiver), std::move(msg));
     }
+};
+
+// Implementation (templated based on Receiver) of a batch match_completion.
+template <execution::receiver Receiver>
+struct match_batch_operation :
+    details::stoppable_operation<match_completion, Receiver>
+{
+    match_batch_operation(match& m, size_t max, Receiver r) :
+        details::stoppable_operation<match_completion, Receiver>(std::move(r),
+                                                                 m, max)
+    {}
 
-    void stop() noexcept override final
+  private:
+    void complete_batch(std::vector<message_t>&& msgs) noexcept override final
     {
-        execution::set_stopped(std::move(receiver));
+        execution::set_value(std::move(this->receiver), std::move(msgs));
     }
-
-    Receiver receiver;
 };
 
 // match Sender implementation.
@@ -140,6 +290,31 @@ struct match_sender
     match& m;
 };
 
+// match batch Sender implementation.
+struct match_batch_sender
+{
+    using sender_concept = execution::sender_t;
+
+    match_batch_sender() = delete;
+    match_batch_sender(match& m, size_t max) noexcept : m(m), max(max) {};
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<
+            execution::set_value_t(std::vector<message_t>),
+            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> match_batch_operation<R>
+    {
+        return {m, max, std::move(r)};
+    }
+
+  private:
+    match& m;
+    size_t max;
+};
+
 }; // namespace match_ns
 
 inline auto match::next() noexcept
@@ -154,4 +329,9 @@ auto match::next() noexcept
            execution::then([](message_t&& m) { return m.unpack<Rs...>(); });
 }
 
+inline auto match::next_batch(size_t max) noexcept
+{
+    return match_ns::match_batch_sender(*this, std::max<size_t>(max, 1));
+}
+
 } // namespace sdbusplus::async
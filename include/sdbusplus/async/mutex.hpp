@@ -1,9 +1,11 @@
 #pragma once
 
 #include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/intrusive_queue.hpp>
+#include <sdbusplus/async/stoppable_operation.hpp>
 #include <sdbusplus/event.hpp>
 
-#include <queue>
+#include <mutex>
 #include <string>
 
 namespace sdbusplus::async
@@ -33,10 +35,11 @@ class mutex
 
   private:
     void unlock();
+    bool cancel(mutex_ns::mutex_completion* c) noexcept;
 
     std::string name;
     bool locked{false};
-    std::queue<mutex_ns::mutex_completion*> waitingTasks;
+    details::intrusive_queue<mutex_ns::mutex_completion> waitingTasks;
     std::mutex lock{};
 };
 
@@ -84,36 +87,40 @@ struct mutex_completion
         mutexInstance(mutexInstance) {};
 
     friend mutex;
+    friend details::intrusive_queue<mutex_completion>;
 
     void start() noexcept;
 
+  protected:
+    bool cancel() noexcept
+    {
+        return mutexInstance.cancel(this);
+    }
+
   private:
     virtual void complete() noexcept = 0;
     virtual void stop() noexcept = 0;
 
     mutex& mutexInstance;
+    mutex_completion* next = nullptr;
+    bool queued = false;
 };
 
 // Implementation (templated based on Receiver) of mutex_completion.
 template <execution::receiver Receiver>
-struct mutex_operation : mutex_completion
+struct mutex_operation :
+    details::stoppable_operation<mutex_completion, Receiver>
 {
     mutex_operation(mutex& mutexInstance, Receiver r) :
-        mutex_completion(mutexInstance), receiver(std::move(r))
+        details::stoppable_operation<mutex_completion, Receiver>(
+            std::move(r), mutexInstance)
     {}
 
   private:
     void complete() noexcept override final
     {
-        execution::set_value(std::move(receiver));
+        execution::set_value(std::move(this->receiver));
     }
-
-    void stop() noexcept override final
-    {
-        execution::set_stopped(std::move(receiver));
-    }
-
-    Receiver receiver;
 };
 
 // mutex sender
@@ -144,8 +151,9 @@ struct mutex_sender
 
 inline auto lock_guard::lock() noexcept
 {
-    owned = true;
-    return mutex_ns::mutex_sender{this->mutexInstance};
+    // Only owned once acquired, since a waiting lock may be cancelled.
+    return mutex_ns::mutex_sender{this->mutexInstance} |
+           execution::then([this]() noexcept { owned = true; });
 }
 
 inline auto lock_guard::unlock() noexcept
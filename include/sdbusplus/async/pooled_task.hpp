@@ -0,0 +1,491 @@
+#pragma once
+
+#include <exec/any_sender_of.hpp>
+#include <exec/inline_scheduler.hpp>
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/frame_pool.hpp>
+
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace sdbusplus::async
+{
+
+/** A `task` whose coroutine frames come from the frame pool of the calling
+ *  thread (see `details::frame_pool`), which is the context's pool on the
+ *  threads running its tasks.
+ *
+ *  Like `task`, a pooled_task is a lazily started coroutine, which is a
+ *  Sender of its `co_return` value.  It runs when `co_await`ed from another
+ *  coroutine, or when connected and started like any other Sender (such as
+ *  by `context::spawn`).  It runs on the scheduler of the environment it was
+ *  started in, and returns to it after each `co_await` of a Sender, wherever
+ *  the Sender completed.  A `co_await`ed pooled_task inherits the scheduler
+ *  and stop token of its parent, and resumes it directly.
+ *
+ *  This is opt-in, for the coroutines of hot paths: a warm pool makes no
+ *  heap allocation per call.
+ */
+template <typename T = void>
+class pooled_task;
+
+namespace pooled_task_ns
+{
+
+/* The scheduler a task returns to, type-erased since it comes from the
+ * environment the task is started in. */
+using any_scheduler = exec::any_receiver_ref<execution::completion_signatures<
+    execution::set_error_t(std::exception_ptr),
+    execution::set_stopped_t()>>::any_sender<>::any_scheduler<>;
+
+/* How a task hands control back to whoever started it: the awaiting task,
+ * or the operation connected to a receiver. */
+struct parent_ref
+{
+    /* Called once the task has returned or thrown. */
+    std::coroutine_handle<> (*complete)(void*) noexcept;
+    /* Called when the task completes as stopped. */
+    std::coroutine_handle<> (*stopped)(void*) noexcept;
+    void* data;
+};
+
+class promise_base
+{
+  public:
+    struct final_awaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename P>
+        auto await_suspend(std::coroutine_handle<P> h) noexcept
+            -> std::coroutine_handle<>
+        {
+            // The parent may destroy this frame, so copy it out first.
+            auto parent = static_cast<promise_base&>(h.promise()).parent;
+            return parent.complete(parent.data);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct env
+    {
+        auto query(execution::get_scheduler_t) const noexcept
+            -> const any_scheduler&
+        {
+            return *self->scheduler;
+        }
+
+        auto query(execution::get_stop_token_t) const noexcept
+            -> execution::inplace_stop_token
+        {
+            return self->token;
+        }
+
+        const promise_base* self;
+    };
+
+    static void* operator new(std::size_t size)
+    {
+        return details::frame_pool::allocate(size);
+    }
+
+    static void operator delete(void* p, std::size_t size) noexcept
+    {
+        details::frame_pool::deallocate(p, size);
+    }
+
+    auto initial_suspend() noexcept -> std::suspend_always
+    {
+        return {};
+    }
+
+    auto final_suspend() noexcept -> final_awaiter
+    {
+        return {};
+    }
+
+    /* Called by the Senders `co_await`ed when they complete as stopped. */
+    auto unhandled_stopped() noexcept -> std::coroutine_handle<>
+    {
+        return parent.stopped(parent.data);
+    }
+
+    auto get_env() const noexcept -> env
+    {
+        return {this};
+    }
+
+    /* Run for a parent, on the scheduler and with the stop token given. */
+    void set_parent(parent_ref p, const any_scheduler* s,
+                    execution::inplace_stop_token t) noexcept
+    {
+        parent = p;
+        scheduler = s;
+        token = t;
+    }
+
+    /* Run for a parent task, on its scheduler and with its stop token. */
+    void set_parent(parent_ref p, const promise_base& other) noexcept
+    {
+        set_parent(p, other.scheduler, other.token);
+    }
+
+  protected:
+    parent_ref parent{};
+    // Owned by the operation running the outermost task, which outlives
+    // all of the tasks it awaits.
+    const any_scheduler* scheduler = nullptr;
+    execution::inplace_stop_token token{};
+};
+
+template <typename T>
+struct promise_result
+{
+    template <typename U = T>
+        requires std::convertible_to<U, T>
+    void return_value(U&& v)
+    {
+        value.emplace(std::forward<U>(v));
+    }
+
+    void unhandled_exception() noexcept
+    {
+        error = std::current_exception();
+    }
+
+    auto result() -> T
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+
+    std::optional<T> value{};
+    std::exception_ptr error{};
+};
+
+template <>
+struct promise_result<void>
+{
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept
+    {
+        error = std::current_exception();
+    }
+
+    void result()
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::exception_ptr error{};
+};
+
+template <typename T>
+class promise;
+
+// Awaiter of a task by another task.
+template <typename T>
+class awaiter
+{
+  public:
+    awaiter() = delete;
+    awaiter(const awaiter&) = delete;
+    awaiter& operator=(const awaiter&) = delete;
+    awaiter(awaiter&&) = delete;
+    awaiter& operator=(awaiter&&) = delete;
+
+    explicit awaiter(std::coroutine_handle<promise<T>> coro) noexcept :
+        coro(coro)
+    {}
+
+    ~awaiter()
+    {
+        if (coro)
+        {
+            coro.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <typename U>
+    auto await_suspend(std::coroutine_handle<promise<U>> parent) noexcept
+        -> std::coroutine_handle<>
+    {
+        coro.promise().set_parent({resume, stopped<U>, parent.address()},
+                                  parent.promise());
+        return coro;
+    }
+
+    auto await_resume() -> T
+    {
+        return coro.promise().result();
+    }
+
+  private:
+    static auto resume(void* data) noexcept -> std::coroutine_handle<>
+    {
+        return std::coroutine_handle<>::from_address(data);
+    }
+
+    // A stopped task stops its parent in turn.
+    template <typename U>
+    static auto stopped(void* data) noexcept -> std::coroutine_handle<>
+    {
+        return std::coroutine_handle<promise<U>>::from_address(data)
+            .promise()
+            .unhandled_stopped();
+    }
+
+    std::coroutine_handle<promise<T>> coro;
+};
+
+template <typename T>
+class promise : public promise_base, public promise_result<T>
+{
+  public:
+    auto get_return_object() noexcept -> pooled_task<T>
+    {
+        return pooled_task<T>{std::coroutine_handle<promise>::from_promise(*this)};
+    }
+
+    // A pooled_task awaited runs on this task's scheduler already, and
+    // resumes this one directly when done.
+    template <typename U>
+    auto await_transform(pooled_task<U>&& t) noexcept -> awaiter<U>
+    {
+        return awaiter<U>{std::exchange(t.coro, {})};
+    }
+
+    template <execution::sender S>
+    auto await_transform(S&& s) -> decltype(auto)
+    {
+        return execution::as_awaitable(
+            execution::continues_on(std::forward<S>(s), *this->scheduler),
+            *this);
+    }
+
+    template <typename A>
+    auto await_transform(A&& a) -> decltype(auto)
+    {
+        return execution::as_awaitable(std::forward<A>(a), *this);
+    }
+};
+
+// Operation running a task for a receiver.
+template <typename T, execution::receiver R>
+class operation
+{
+  public:
+    operation() = delete;
+    operation(const operation&) = delete;
+    operation& operator=(const operation&) = delete;
+    operation(operation&&) = delete;
+    operation& operator=(operation&&) = delete;
+
+    operation(std::coroutine_handle<promise<T>> coro, R r) :
+        coro(coro), receiver(std::move(r))
+    {}
+
+    ~operation()
+    {
+        if (coro)
+        {
+            coro.destroy();
+        }
+    }
+
+    void start() noexcept
+    {
+        auto env = execution::get_env(receiver);
+
+        if constexpr (requires { execution::get_scheduler(env); })
+        {
+            scheduler.emplace(execution::get_scheduler(env));
+        }
+        else
+        {
+            scheduler.emplace(exec::inline_scheduler{});
+        }
+
+        execution::inplace_stop_token token{};
+        if constexpr (std::same_as<stop_token_t, execution::inplace_stop_token>)
+        {
+            token = execution::get_stop_token(env);
+        }
+        else if constexpr (forwards_stop)
+        {
+            stop.callback.emplace(execution::get_stop_token(env),
+                                  stop_requested{&stop.source});
+            token = stop.source.get_token();
+        }
+
+        coro.promise().set_parent({complete, stopped, this}, &*scheduler,
+                                  token);
+        coro.resume();
+    }
+
+  private:
+    static auto complete(void* data) noexcept -> std::coroutine_handle<>
+    {
+        auto self = static_cast<operation*>(data);
+        auto& p = self->coro.promise();
+
+        // The receiver may destroy this operation, and the frame with it,
+        // so the result is moved out first.
+        if (p.error)
+        {
+            execution::set_error(std::move(self->receiver),
+                                 std::exchange(p.error, {}));
+        }
+        else if constexpr (std::is_void_v<T>)
+        {
+            execution::set_value(std::move(self->receiver));
+        }
+        else
+        {
+            T value = std::move(*p.value);
+            execution::set_value(std::move(self->receiver), std::move(value));
+        }
+
+        return std::noop_coroutine();
+    }
+
+    static auto stopped(void* data) noexcept -> std::coroutine_handle<>
+    {
+        execution::set_stopped(
+            std::move(static_cast<operation*>(data)->receiver));
+        return std::noop_coroutine();
+    }
+
+    struct stop_requested
+    {
+        void operator()() noexcept
+        {
+            source->request_stop();
+        }
+
+        execution::inplace_stop_source* source;
+    };
+
+    using stop_token_t = execution::stop_token_of_t<execution::env_of_t<R>>;
+
+    // Stop tokens other than the tasks' own are forwarded to a source of
+    // it; a token which can never be stopped is left out.
+    static constexpr bool forwards_stop =
+        !std::same_as<stop_token_t, execution::inplace_stop_token> &&
+        !execution::unstoppable_token<stop_token_t>;
+
+    struct stop_forwarding
+    {
+        execution::inplace_stop_source source{};
+        // Destroyed first, waiting for a concurrent stop request to finish.
+        std::optional<execution::stop_callback_for_t<stop_token_t,
+                                                     stop_requested>>
+            callback{};
+    };
+    struct no_stop_forwarding
+    {};
+
+    std::coroutine_handle<promise<T>> coro;
+    R receiver;
+    std::optional<any_scheduler> scheduler{};
+    [[no_unique_address]] std::conditional_t<forwards_stop, stop_forwarding,
+                                             no_stop_forwarding> stop{};
+};
+
+template <typename T>
+struct value_signature
+{
+    using type = execution::set_value_t(T);
+};
+
+template <>
+struct value_signature<void>
+{
+    using type = execution::set_value_t();
+};
+
+} // namespace pooled_task_ns
+
+template <typename T>
+class pooled_task
+{
+  public:
+    using promise_type = pooled_task_ns::promise<T>;
+    using sender_concept = execution::sender_t;
+
+    pooled_task() = delete;
+    pooled_task(const pooled_task&) = delete;
+    pooled_task& operator=(const pooled_task&) = delete;
+
+    pooled_task(pooled_task&& other) noexcept :
+        coro(std::exchange(other.coro, {}))
+    {}
+
+    pooled_task& operator=(pooled_task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (coro)
+            {
+                coro.destroy();
+            }
+            coro = std::exchange(other.coro, {});
+        }
+        return *this;
+    }
+
+    ~pooled_task()
+    {
+        if (coro)
+        {
+            coro.destroy();
+        }
+    }
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<
+            typename pooled_task_ns::value_signature<T>::type,
+            execution::set_error_t(std::exception_ptr),
+            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) && -> pooled_task_ns::operation<T, R>
+    {
+        return {std::exchange(coro, {}), std::move(r)};
+    }
+
+  private:
+    friend promise_type;
+    template <typename>
+    friend class pooled_task_ns::promise;
+
+    explicit pooled_task(std::coroutine_handle<promise_type> coro) noexcept :
+        coro(coro)
+    {}
+
+    std::coroutine_handle<promise_type> coro;
+};
+
+} // namespace sdbusplus::async
@@ -4,6 +4,8 @@
 #include <sdbusplus/async/context.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <chrono>
+#include <concepts>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -14,6 +16,11 @@ namespace sdbusplus::async
 {
 namespace proxy_ns
 {
+/** The target of a proxy operation: a context or a bus. */
+template <typename T>
+concept proxy_target =
+    std::same_as<T, context> || std::derived_from<T, sdbusplus::bus_t>;
+
 /** A (client-side) proxy to a dbus object.
  *
  *  A dbus object is referenced by 3 address pieces:
@@ -47,6 +54,16 @@ namespace proxy_ns
  *  previously-supplied string_views.  The `preserve` operation can be used
  *  to transform an existing proxy into one which is safe to leave (because
  *  it uses less-efficient but safe std::string values).
+ *
+ *  A proxy may also carry a method-call timeout, set with `timeout`, which
+ *  applies to every operation performed through it.  Without one, the sd-bus
+ *  default timeout is used.
+ *
+ *  Operations use the primary bus of the context, unless the proxy is bound
+ *  to a bus attached to the context with `on_bus`.  They may instead be
+ *  given a bus processed outside of any context, such as an
+ *  `asio::connection`, in which case the awaiting task is resumed by the
+ *  processing of that bus.
  */
 template <bool S = false, bool P = false, bool I = false,
           bool Preserved = false>
@@ -73,24 +90,47 @@ struct proxy : private sdbusplus::details::bus_friend
     = delete;
 
     // Constructor allowing all 3 to be passed in.
-    constexpr proxy(value_ref<S> s, value_ref<P> p, value_ref<I> i) :
-        s(s), p(p), i(i) {};
+    constexpr proxy(value_ref<S> s, value_ref<P> p, value_ref<I> i,
+                    std::chrono::microseconds t = {}, bus_t* b = nullptr) :
+        s(s), p(p), i(i), t(t), b(b) {};
 
     // Functions to assign address fields.
     constexpr auto service(string_ref s) const noexcept
         requires(!S)
     {
-        return proxy<true, P, I, Preserved>{s, this->p, this->i};
+        return proxy<true, P, I, Preserved>{s, this->p, this->i, this->t,
+                                            this->b};
     }
     constexpr auto path(string_ref p) const noexcept
         requires(!P)
     {
-        return proxy<S, true, I, Preserved>{this->s, p, this->i};
+        return proxy<S, true, I, Preserved>{this->s, p, this->i, this->t,
+                                            this->b};
     }
     constexpr auto interface(string_ref i) const noexcept
         requires(!I)
     {
-        return proxy<S, P, true, Preserved>{this->s, this->p, i};
+        return proxy<S, P, true, Preserved>{this->s, this->p, i, this->t,
+                                            this->b};
+    }
+
+    /** Set the timeout of operations performed through the proxy.
+     *
+     *  A call which does not complete in time fails with an SdBusError of
+     *  ETIMEDOUT.  A zero timeout selects the sd-bus default.
+     */
+    constexpr auto timeout(std::chrono::microseconds t) const noexcept
+    {
+        return proxy<S, P, I, Preserved>{this->s, this->p, this->i, t,
+                                         this->b};
+    }
+
+    /** Perform the operations on `bus`, which must be the primary bus of
+     *  the context used or attached to it (see `context::attach_bus`). */
+    constexpr auto on_bus(bus_t& bus) const noexcept
+    {
+        return proxy<S, P, I, Preserved>{this->s, this->p, this->i, this->t,
+                                         &bus};
     }
 
     /** Make a copyable / returnable proxy.
@@ -107,7 +147,8 @@ struct proxy : private sdbusplus::details::bus_friend
         using result_t = proxy<S, P, I, true>;
         return result_t(typename result_t::template value_t<S>(this->s),
                         typename result_t::template value_t<P>(this->p),
-                        typename result_t::template value_t<I>(this->i));
+                        typename result_t::template value_t<I>(this->i),
+                        this->t, this->b);
     }
 
     /** Perform a method call.
@@ -115,19 +156,22 @@ struct proxy : private sdbusplus::details::bus_friend
      *  @tparam Rs - The return type(s) of the method call.
      *  @tparam Ss - The parameter type(s) of the method call.
      *
-     *  @param[in] ctx - The context to use.
+     *  @param[in] ctx - The context, or bus, to use.
      *  @param[in] method - The method name.
      *  @param[in] ss - The calling parameters.
      *
      *  @return A Sender which completes with either { void, Rs, tuple<Rs...> }.
+     *          A stop request on the awaiting Receiver cancels the call.
      */
-    template <typename... Rs, typename... Ss>
-    auto call(context& ctx, sv_ref method, Ss&&... ss) const
+    template <typename... Rs, proxy_target Target, typename... Ss>
+    auto call(Target& ctx, sv_ref method, Ss&&... ss) const
         requires((S) && (P) && (I))
     {
+        auto& bus = target_bus(ctx);
+
         // Create the method_call message.
-        auto msg = ctx.get_bus().new_method_call(c_str(s), c_str(p), c_str(i),
-                                                 method.data());
+        auto msg = bus.new_method_call(c_str(s), c_str(p), c_str(i),
+                                       method.data());
         if constexpr (sizeof...(Ss) > 0)
         {
             msg.append(std::forward<Ss>(ss)...);
@@ -135,10 +179,11 @@ struct proxy : private sdbusplus::details::bus_friend
 
         // Use 'callback' to perform the operation and "then" "unpack" the
         // contents.
-        return callback([bus = get_busp(ctx),
-                         msg = std::move(msg)](auto cb, auto data) mutable {
-                   return sd_bus_call_async(bus, nullptr, msg.get(), cb, data,
-                                            0);
+        return callback([bus = get_busp(bus), msg = std::move(msg),
+                         usec = static_cast<uint64_t>(t.count())](
+                            sd_bus_slot** slot, auto cb, auto data) mutable {
+                   return sd_bus_call_async(bus, slot, msg.get(), cb, data,
+                                            usec);
                }) |
                execution::then([](message_t&& m) { return m.unpack<Rs...>(); });
     }
@@ -147,17 +192,17 @@ struct proxy : private sdbusplus::details::bus_friend
      *
      *  @tparam T - The type of the property.
      *
-     *  @param[in] ctx - The context to use.
+     *  @param[in] ctx - The context, or bus, to use.
      *  @param[in] property - The property name.
      *
      *  @return A Sender which completes with T as the property value.
      */
-    template <typename T>
-    auto get_property(context& ctx, sv_ref property) const
+    template <typename T, proxy_target Target>
+    auto get_property(Target& ctx, sv_ref property) const
         requires((S) && (P) && (I))
     {
         using result_t = std::variant<T>;
-        auto prop_intf = proxy(s, p, dbus_prop_intf);
+        auto prop_intf = proxy(s, p, dbus_prop_intf, t, b);
 
         return prop_intf.template call<result_t>(ctx, "Get", c_str(i),
                                                  property.data()) |
@@ -168,16 +213,16 @@ struct proxy : private sdbusplus::details::bus_friend
      *
      * @tparam V - The variant type of all possible properties.
      *
-     * @param[in] ctx - The context to use.
+     * @param[in] ctx - The context, or bus, to use.
      *
      * @return A Sender which completes with unordered_map<string, V>.
      */
-    template <typename V>
-    auto get_all_properties(context& ctx) const
+    template <typename V, proxy_target Target>
+    auto get_all_properties(Target& ctx) const
         requires((S) && (P) && (I))
     {
         using result_t = std::unordered_map<std::string, V>;
-        auto prop_intf = proxy(s, p, dbus_prop_intf);
+        auto prop_intf = proxy(s, p, dbus_prop_intf, t, b);
 
         return prop_intf.template call<result_t>(ctx, "GetAll", c_str(i));
     }
@@ -186,17 +231,17 @@ struct proxy : private sdbusplus::details::bus_friend
      *
      * @tparam T - The type of the property (usually deduced by the compiler).
      *
-     * @param[in] ctx - The context to use.
+     * @param[in] ctx - The context, or bus, to use.
      * @param[in] property - The property name.
      * @param[in] value - The value to set.
      *
      * @return A Sender which completes void when the property is set.
      */
-    template <typename T>
-    auto set_property(context& ctx, sv_ref property, T&& value) const
+    template <typename T, proxy_target Target>
+    auto set_property(Target& ctx, sv_ref property, T&& value) const
         requires((S) && (P) && (I))
     {
-        auto prop_intf = proxy(s, p, dbus_prop_intf);
+        auto prop_intf = proxy(s, p, dbus_prop_intf, t, b);
         return prop_intf.template call<>(
             ctx, "Set", c_str(i), property.data(),
             std::variant<std::decay_t<T>>{std::forward<T>(value)});
@@ -205,6 +250,16 @@ struct proxy : private sdbusplus::details::bus_friend
   private:
     static constexpr auto dbus_prop_intf = "org.freedesktop.DBus.Properties";
 
+    // The bus of an operation: the bound bus, or the context's primary bus.
+    bus_t& target_bus(context& ctx) const noexcept
+    {
+        return (b != nullptr) ? *b : ctx.get_bus();
+    }
+    static bus_t& target_bus(bus_t& bus) noexcept
+    {
+        return bus;
+    }
+
     // Helper to get the underlying c-string of a string_view or string.
     static auto c_str(string_ref v)
     {
@@ -221,6 +276,8 @@ struct proxy : private sdbusplus::details::bus_friend
     value_t<S> s = {};
     value_t<P> p = {};
     value_t<I> i = {};
+    std::chrono::microseconds t = {};
+    bus_t* b = nullptr;
 };
 
 } // namespace proxy_ns
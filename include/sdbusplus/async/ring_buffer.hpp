@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace sdbusplus::async::details
+{
+
+/** A FIFO queue stored in a circular buffer.
+ *
+ *  The buffer is allocated on first use and only grows when the queue does
+ *  not fit, so a queue held under its `limit` never allocates again.  The
+ *  limit itself is advisory: `full` reports it, but `push_back` still
+ *  accepts elements past it, leaving the overflow policy to the owner.
+ *  A limit of 0 is unbounded.
+ */
+template <typename T>
+class ring_buffer
+{
+  public:
+    explicit ring_buffer(size_t limit = 0) : limit(limit) {}
+
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    bool full() const noexcept
+    {
+        return (limit != 0) && (count >= limit);
+    }
+
+    T& front()
+    {
+        return *slots[head];
+    }
+
+    /** Access the i-th oldest element. */
+    T& operator[](size_t i)
+    {
+        return *slots[index(i)];
+    }
+
+    void push_back(T&& value)
+    {
+        if (count == slots.size())
+        {
+            grow();
+        }
+        slots[index(count)].emplace(std::move(value));
+        ++count;
+    }
+
+    T pop_front()
+    {
+        T value = std::move(*slots[head]);
+        slots[head].reset();
+        head = (head + 1) % slots.size();
+        --count;
+        return value;
+    }
+
+  private:
+    size_t index(size_t i) const noexcept
+    {
+        return (head + i) % slots.size();
+    }
+
+    void grow()
+    {
+        size_t capacity = std::max<size_t>(slots.size() * 2, 8);
+        if ((limit != 0) && (slots.size() < limit))
+        {
+            capacity = limit;
+        }
+
+        std::vector<std::optional<T>> resized(capacity);
+        for (size_t i = 0; i < count; ++i)
+        {
+            resized[i] = std::move(slots[index(i)]);
+        }
+
+        slots = std::move(resized);
+        head = 0;
+    }
+
+    size_t limit;
+    std::vector<std::optional<T>> slots{};
+    size_t head = 0;
+    size_t count = 0;
+};
+
+} // namespace sdbusplus::async::details
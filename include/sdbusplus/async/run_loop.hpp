@@ -0,0 +1,486 @@
+#pragma once
+
+#include <sdbusplus/async/execution.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace sdbusplus::async
+{
+
+/** The priority of the tasks of a context.
+ *
+ *  Ready tasks of a higher priority run before those of a lower one, such as
+ *  a watchdog or method replies ahead of a bulk refresh; tasks of the same
+ *  priority run in FIFO order.
+ */
+enum class priority : uint8_t
+{
+    low,
+    normal,
+    high,
+};
+
+namespace details
+{
+
+/** A run-loop of tasks by priority, used as the scheduler of a context.
+ *
+ *  This behaves as `execution::run_loop`: `run` executes tasks until
+ *  `finish` is called, and tasks may be scheduled from any thread.  In
+ *  addition, the loop can be driven one batch at a time with `run_pending`,
+ *  so that it can share a thread with an sd-event loop.  A thread which is
+ *  about to block elsewhere marks the loop idle with `try_idle`; scheduling
+ *  a task onto an idle loop calls the wakeup function so that the thread
+ *  can return to the loop.
+ *
+ *  Each priority has its own FIFO queue, and `run` takes the next task from
+ *  the highest non-empty queue.  So that a busy higher priority cannot
+ *  starve a lower one, a queue which has been passed over `starvation_limit`
+ *  times while non-empty runs its next task ahead of the higher queues.
+ *
+ *  The loop counts the tasks it runs, the time they waited to run once
+ *  ready, and the time spent running them; see `get_stats`.
+ */
+class run_loop
+{
+  public:
+    class scheduler;
+
+    static constexpr size_t priorities = 3;
+
+    using clock = std::chrono::steady_clock;
+
+    /** Counters of the tasks run by the loop. */
+    struct stats
+    {
+        /** Number of tasks run. */
+        uint64_t tasks = 0;
+        /** Total time the tasks waited to run, once scheduled. */
+        std::chrono::nanoseconds lag{};
+        /** Longest time a task waited to run, once scheduled. */
+        std::chrono::nanoseconds max_lag{};
+        /** Total time spent running tasks. */
+        std::chrono::nanoseconds busy{};
+    };
+
+  private:
+    struct task
+    {
+        task* next = nullptr;
+        void (*execute)(task*) noexcept = nullptr;
+        priority prio = priority::normal;
+        clock::time_point ready{};
+    };
+
+    template <execution::receiver R>
+    struct operation : task
+    {
+        operation(run_loop* loop, R r, priority p) :
+            task{nullptr, &run, p}, loop(loop), receiver(std::move(r))
+        {}
+
+        operation(operation&&) = delete;
+
+        static void run(task* t) noexcept
+        {
+            auto self = static_cast<operation*>(t);
+
+            if (execution::get_stop_token(execution::get_env(self->receiver))
+                    .stop_requested())
+            {
+                execution::set_stopped(std::move(self->receiver));
+            }
+            else
+            {
+                execution::set_value(std::move(self->receiver));
+            }
+        }
+
+        void start() noexcept
+        {
+            loop->push_back(this);
+        }
+
+        run_loop* loop;
+        R receiver;
+    };
+
+    struct schedule_env
+    {
+        template <typename CPO>
+        auto query(execution::get_completion_scheduler_t<CPO>) const noexcept
+            -> scheduler;
+
+        run_loop* loop;
+        priority prio;
+    };
+
+    struct schedule_sender
+    {
+        using sender_concept = execution::sender_t;
+
+        template <typename Self, class... Env>
+        static constexpr auto get_completion_signatures(Self&&, Env&&...)
+            -> execution::completion_signatures<execution::set_value_t(),
+                                                execution::set_stopped_t()>;
+
+        template <execution::receiver R>
+        auto connect(R r) const -> operation<R>
+        {
+            return {loop, std::move(r), prio};
+        }
+
+        auto get_env() const noexcept -> schedule_env
+        {
+            return {loop, prio};
+        }
+
+        run_loop* loop;
+        priority prio;
+    };
+
+  public:
+    class scheduler
+    {
+      public:
+        using scheduler_concept = execution::scheduler_t;
+
+        explicit scheduler(run_loop* loop,
+                           priority prio = priority::normal) noexcept :
+            loop(loop), prio(prio)
+        {}
+
+        auto schedule() const noexcept -> schedule_sender
+        {
+            return {loop, prio};
+        }
+
+        /** The priority of the tasks scheduled. */
+        auto get_priority() const noexcept -> priority
+        {
+            return prio;
+        }
+
+        auto query(execution::get_forward_progress_guarantee_t) const noexcept
+            -> execution::forward_progress_guarantee
+        {
+            return execution::forward_progress_guarantee::parallel;
+        }
+
+        bool operator==(const scheduler&) const noexcept = default;
+
+      private:
+        run_loop* loop;
+        priority prio;
+    };
+
+    /** Set the times a queue is passed over before it runs ahead; at least
+     *  1. */
+    explicit run_loop(size_t starvation_limit = 16) :
+        starvation_limit(std::max<size_t>(starvation_limit, 1))
+    {}
+    run_loop(const run_loop&) = delete;
+    run_loop& operator=(const run_loop&) = delete;
+
+    auto get_scheduler(priority prio = priority::normal) noexcept -> scheduler
+    {
+        return scheduler{this, prio};
+    }
+
+    /** Get the task counters; safe to call from any thread. */
+    auto get_stats() const noexcept -> stats
+    {
+        return {stat_tasks.load(std::memory_order_relaxed),
+                std::chrono::nanoseconds(
+                    stat_lag.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(
+                    stat_max_lag.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(
+                    stat_busy.load(std::memory_order_relaxed))};
+    }
+
+    /** The priority of the task being executed by the calling thread, or
+     *  `normal` outside of a task. */
+    static auto current_priority() noexcept -> priority
+    {
+        return current;
+    }
+
+    /** Override the current priority while in scope, such as for work which
+     *  a task runs on behalf of others. */
+    class priority_scope
+    {
+      public:
+        priority_scope(const priority_scope&) = delete;
+        priority_scope& operator=(const priority_scope&) = delete;
+
+        explicit priority_scope(priority prio) noexcept :
+            previous(std::exchange(current, prio))
+        {}
+        ~priority_scope()
+        {
+            current = previous;
+        }
+
+      private:
+        priority previous;
+    };
+
+    /** Execute tasks until `finish` is called and no tasks remain. */
+    void run()
+    {
+        while (auto t = pop_front())
+        {
+            execute(t);
+        }
+    }
+
+    /** Allow `run` to return once the queue is empty. */
+    void finish()
+    {
+        {
+            std::lock_guard l{lock};
+            finishing = true;
+        }
+        cv.notify_all();
+    }
+
+    /** Execute the tasks queued at the time of the call, but not tasks
+     *  queued by them, without blocking.
+     *
+     *  @return The number of tasks executed.
+     */
+    size_t run_pending()
+    {
+        std::array<task*, priorities> taken{};
+        {
+            std::lock_guard l{lock};
+            for (size_t i = 0; i < priorities; ++i)
+            {
+                taken[i] = std::exchange(queues[i].head, nullptr);
+                queues[i].tail = nullptr;
+                queues[i].passed = 0;
+            }
+        }
+
+        // The whole batch runs, so the higher priorities just go first.
+        size_t count = 0;
+        for (size_t i = priorities; i-- > 0;)
+        {
+            auto t = taken[i];
+            while (t != nullptr)
+            {
+                // The task may be destroyed by executing it.
+                auto next = t->next;
+                execute(t);
+                t = next;
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /** Mark the loop idle, if no tasks are queued.
+     *
+     *  @return true if the loop is now idle; the next task scheduled will
+     *          call the wakeup function and clear the idle state.
+     */
+    bool try_idle()
+    {
+        std::lock_guard l{lock};
+        if (!empty())
+        {
+            return false;
+        }
+        idle = true;
+        return true;
+    }
+
+    /** Clear the idle state set by `try_idle`. */
+    void end_idle()
+    {
+        std::lock_guard l{lock};
+        idle = false;
+    }
+
+    /** Set the function called when a task is scheduled onto an idle loop.
+     */
+    void set_wakeup(std::function<void()>&& f)
+    {
+        wakeup = std::move(f);
+    }
+
+  private:
+    struct queue
+    {
+        task* head = nullptr;
+        task* tail = nullptr;
+        /** Tasks run from higher queues while this one was non-empty. */
+        size_t passed = 0;
+    };
+
+    void execute(task* t) noexcept
+    {
+        auto start = clock::now();
+        auto lag = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       start - t->ready)
+                       .count();
+
+        {
+            // The task may be destroyed by executing it.
+            priority_scope scope{t->prio};
+            t->execute(t);
+        }
+
+        auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        clock::now() - start)
+                        .count();
+
+        // The tasks are run by one thread at a time, so the counters have a
+        // single writer.
+        add(stat_tasks, 1);
+        add(stat_lag, lag);
+        add(stat_busy, busy);
+        if (static_cast<uint64_t>(lag) >
+            stat_max_lag.load(std::memory_order_relaxed))
+        {
+            stat_max_lag.store(lag, std::memory_order_relaxed);
+        }
+    }
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept
+    {
+        for (const auto& q : queues)
+        {
+            if (q.head != nullptr)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void push_back(task* t)
+    {
+        t->ready = clock::now();
+
+        bool wake = false;
+        {
+            std::lock_guard l{lock};
+            auto& q = queues[static_cast<size_t>(t->prio)];
+            t->next = nullptr;
+            if (q.tail != nullptr)
+            {
+                q.tail->next = t;
+            }
+            else
+            {
+                q.head = t;
+            }
+            q.tail = t;
+            wake = std::exchange(idle, false);
+        }
+        cv.notify_one();
+
+        if (wake && wakeup)
+        {
+            wakeup();
+        }
+    }
+
+    task* pop_front()
+    {
+        std::unique_lock l{lock};
+        cv.wait(l, [this] { return !empty() || finishing; });
+
+        // A starved queue goes first, the lowest being the longest starved;
+        // otherwise the highest non-empty queue.
+        queue* chosen = nullptr;
+        for (auto& q : queues)
+        {
+            if ((q.head != nullptr) && (q.passed >= starvation_limit))
+            {
+                chosen = &q;
+                break;
+            }
+        }
+        if (chosen == nullptr)
+        {
+            for (size_t i = priorities; i-- > 0;)
+            {
+                if (queues[i].head != nullptr)
+                {
+                    chosen = &queues[i];
+                    break;
+                }
+            }
+        }
+        if (chosen == nullptr)
+        {
+            return nullptr;
+        }
+
+        for (auto& q : queues)
+        {
+            if (&q == chosen)
+            {
+                q.passed = 0;
+            }
+            else if ((&q < chosen) && (q.head != nullptr))
+            {
+                ++q.passed;
+            }
+        }
+
+        auto t = chosen->head;
+        chosen->head = t->next;
+        if (chosen->head == nullptr)
+        {
+            chosen->tail = nullptr;
+        }
+        return t;
+    }
+
+    static inline thread_local priority current = priority::normal;
+
+    std::mutex lock{};
+    std::condition_variable cv{};
+    /** The queues, indexed by priority. */
+    std::array<queue, priorities> queues{};
+    size_t starvation_limit;
+    bool finishing = false;
+
+    // Counters for `get_stats`, in nanoseconds for the times.
+    std::atomic<uint64_t> stat_tasks{0};
+    std::atomic<uint64_t> stat_lag{0};
+    std::atomic<uint64_t> stat_max_lag{0};
+    std::atomic<uint64_t> stat_busy{0};
+    bool idle = false;
+    std::function<void()> wakeup{};
+};
+
+template <typename CPO>
+inline auto run_loop::schedule_env::query(
+    execution::get_completion_scheduler_t<CPO>) const noexcept -> scheduler
+{
+    return scheduler{loop, prio};
+}
+
+} // namespace details
+
+} // namespace sdbusplus::async
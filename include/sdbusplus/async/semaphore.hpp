@@ -0,0 +1,200 @@
+#pragma once
+
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/intrusive_queue.hpp>
+#include <sdbusplus/async/stoppable_operation.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace sdbusplus::async
+{
+
+namespace semaphore_ns
+{
+struct semaphore_completion;
+} // namespace semaphore_ns
+
+/** An asynchronous counting semaphore, such as for limiting the number of
+ *  tasks doing something concurrently.
+ *
+ *  The count is a single atomic word, so acquiring an available permit, or
+ *  releasing one nobody waits for, neither allocates nor takes a system
+ *  mutex.  Waiters are queued within their own operation state and handed
+ *  the released permits in order.
+ */
+class semaphore
+{
+  public:
+    semaphore() = delete;
+    semaphore(const semaphore&) = delete;
+    semaphore& operator=(const semaphore&) = delete;
+    semaphore(semaphore&&) = delete;
+    semaphore& operator=(semaphore&&) = delete;
+    ~semaphore() = default;
+
+    explicit semaphore(size_t permits,
+                       const std::string& name = "sdbusplus::async::semaphore");
+
+    /** Sender completing once a permit has been acquired. */
+    auto acquire() noexcept;
+    bool try_acquire() noexcept;
+
+    /** Release `count` permits. */
+    void release(size_t count = 1) noexcept;
+
+    friend semaphore_ns::semaphore_completion;
+
+  private:
+    static constexpr uint64_t waitingBit = uint64_t{1} << 63;
+
+    /** Queue a waiter, unless a permit can be taken right away. */
+    bool wait(semaphore_ns::semaphore_completion* c) noexcept;
+    /** Remove a waiter, for a stop request. */
+    bool cancel(semaphore_ns::semaphore_completion* c) noexcept;
+
+    std::string name;
+
+    /** The number of available permits, or waitingBit when the queue is
+     *  non-empty (and no permits are available). */
+    std::atomic<uint64_t> state;
+
+    std::mutex queueLock{};
+    details::intrusive_queue<semaphore_ns::semaphore_completion> waitingTasks{};
+};
+
+namespace semaphore_ns
+{
+
+struct semaphore_completion
+{
+    semaphore_completion() = delete;
+    semaphore_completion(const semaphore_completion&) = delete;
+    semaphore_completion& operator=(const semaphore_completion&) = delete;
+    semaphore_completion(semaphore_completion&&) = delete;
+    ~semaphore_completion() = default;
+
+    explicit semaphore_completion(semaphore& semaphoreInstance) noexcept :
+        semaphoreInstance(semaphoreInstance)
+    {}
+
+    friend semaphore;
+    friend details::intrusive_queue<semaphore_completion>;
+
+    void start() noexcept
+    {
+        if (semaphoreInstance.try_acquire() || semaphoreInstance.wait(this))
+        {
+            complete();
+        }
+    }
+
+  protected:
+    bool cancel() noexcept
+    {
+        return semaphoreInstance.cancel(this);
+    }
+
+  private:
+    virtual void complete() noexcept = 0;
+    virtual void stop() noexcept = 0;
+
+    semaphore& semaphoreInstance;
+    semaphore_completion* next = nullptr;
+    bool queued = false;
+};
+
+// Implementation (templated based on Receiver) of semaphore_completion.
+template <execution::receiver Receiver>
+struct semaphore_operation :
+    details::stoppable_operation<semaphore_completion, Receiver>
+{
+    semaphore_operation(semaphore& semaphoreInstance, Receiver r) :
+        details::stoppable_operation<semaphore_completion, Receiver>(
+            std::move(r), semaphoreInstance)
+    {}
+
+  private:
+    void complete() noexcept override final
+    {
+        execution::set_value(std::move(this->receiver));
+    }
+};
+
+// semaphore sender
+struct semaphore_sender
+{
+    using sender_concept = execution::sender_t;
+
+    semaphore_sender() = delete;
+    explicit semaphore_sender(semaphore& semaphoreInstance) noexcept :
+        semaphoreInstance(semaphoreInstance)
+    {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<execution::set_value_t(),
+                                            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> semaphore_operation<R>
+    {
+        return {semaphoreInstance, std::move(r)};
+    }
+
+  private:
+    semaphore& semaphoreInstance;
+};
+
+} // namespace semaphore_ns
+
+// RAII wrapper holding a semaphore permit for the duration of a scoped block.
+class semaphore_guard
+{
+  public:
+    semaphore_guard() = delete;
+    semaphore_guard(const semaphore_guard&) = delete;
+    semaphore_guard& operator=(const semaphore_guard&) = delete;
+    semaphore_guard(semaphore_guard&&) = delete;
+    semaphore_guard& operator=(semaphore_guard&&) = delete;
+
+    explicit semaphore_guard(semaphore& semaphoreInstance) :
+        semaphoreInstance(semaphoreInstance)
+    {}
+
+    ~semaphore_guard()
+    {
+        release();
+    }
+
+    auto acquire() noexcept
+    {
+        // Only owned once acquired, since a waiting acquire may be
+        // cancelled.
+        return semaphore_ns::semaphore_sender{semaphoreInstance} |
+               execution::then([this]() noexcept { owned = true; });
+    }
+
+    void release() noexcept
+    {
+        if (owned)
+        {
+            semaphoreInstance.release();
+            owned = false;
+        }
+    }
+
+  private:
+    semaphore& semaphoreInstance;
+    bool owned = false;
+};
+
+inline auto semaphore::acquire() noexcept
+{
+    return semaphore_ns::semaphore_sender{*this};
+}
+
+} // namespace sdbusplus::async
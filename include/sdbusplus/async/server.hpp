@@ -1,14 +1,51 @@
 #pragma once
 
 #include <sdbusplus/async/context.hpp>
+#include <sdbusplus/async/semaphore.hpp>
 #include <sdbusplus/server/manager.hpp>
 #include <sdbusplus/vtable.hpp>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <new>
+#include <optional>
+#include <utility>
 
 namespace sdbusplus::async
 {
 
+/** Limits on the asynchronous method calls an interface runs at once.
+ *
+ *  Calls beyond `max_concurrent` wait, in order, for a running call to
+ *  finish; once `max_queued` calls are waiting, further calls are rejected
+ *  with `org.freedesktop.DBus.Error.LimitsExceeded`.  Calls to methods
+ *  which are not coroutines complete within their callback, and are not
+ *  limited.
+ */
+struct method_limits
+{
+    /** The number of calls run concurrently; 0 for no limit. */
+    size_t max_concurrent = 0;
+    /** The number of calls waiting to run. */
+    size_t max_queued = 0;
+};
+
+/** Counters describing the asynchronous method calls of a server. */
+struct method_stats
+{
+    /** Calls accepted, whether run at once or after waiting. */
+    uint64_t admitted = 0;
+    /** Calls which had to wait to run. */
+    uint64_t queued = 0;
+    /** Calls rejected as exceeding the limits. */
+    uint64_t rejected = 0;
+    /** Calls currently running. */
+    size_t running = 0;
+    /** Calls currently waiting to run. */
+    size_t waiting = 0;
+};
+
 namespace server
 {
 
@@ -17,9 +54,28 @@ namespace details
 struct server_context_friend;
 }
 
+/* The bus a server is registered on; a base preceding the generated Types,
+ * so it is available while they are constructed. */
+class server_bus_ref
+{
+  public:
+    server_bus_ref() = delete;
+    explicit server_bus_ref(sdbusplus::bus_t& bus) : serverBus(bus) {}
+
+  protected:
+    sdbusplus::bus_t& serverBus;
+};
+
+/** An async server, hosting the `Types` interfaces on an object path.
+ *
+ *  The server is registered on the context's primary bus, or on a bus given
+ *  to the constructor, which must be attached to the context (see
+ *  `context::attach_bus`).
+ */
 template <typename Instance, template <typename, typename> typename... Types>
 class server :
     public sdbusplus::async::context_ref,
+    public server_bus_ref,
     public Types<Instance, server<Instance, Types...>>...
 {
   public:
@@ -28,24 +84,83 @@ class server :
 
     server() = delete;
     explicit server(sdbusplus::async::context& ctx, const char* path) :
-        context_ref(ctx), Types<Instance, Self>(path)...
+        server(ctx, ctx.get_bus(), path)
     {}
     explicit server(sdbusplus::async::context& ctx,
                     const sdbusplus::object_path& path) :
-        context_ref(ctx), Types<Instance, Self>(path)...
+        server(ctx, ctx.get_bus(), path)
+    {}
+    explicit server(sdbusplus::async::context& ctx, sdbusplus::bus_t& bus,
+                    const char* path) :
+        context_ref(ctx), server_bus_ref(bus), Types<Instance, Self>(path)...
+    {}
+    explicit server(sdbusplus::async::context& ctx, sdbusplus::bus_t& bus,
+                    const sdbusplus::object_path& path) :
+        context_ref(ctx), server_bus_ref(bus), Types<Instance, Self>(path)...
     {}
 
     // This constructor accepting one properties_t per interface:
     explicit server(
         sdbusplus::async::context& ctx, const char* path,
         typename Types<Instance, Self>::properties_t... propValues) :
-        context_ref(ctx), Types<Instance, Self>(path, propValues)...
+        server(ctx, ctx.get_bus(), path, propValues...)
     {}
     explicit server(
         sdbusplus::async::context& ctx, const sdbusplus::object_path& path,
         typename Types<Instance, Self>::properties_t... propValues) :
-        context_ref(ctx), Types<Instance, Self>(path, propValues)...
+        server(ctx, ctx.get_bus(), path, propValues...)
     {}
+    explicit server(
+        sdbusplus::async::context& ctx, sdbusplus::bus_t& bus,
+        const char* path,
+        typename Types<Instance, Self>::properties_t... propValues) :
+        context_ref(ctx), server_bus_ref(bus),
+        Types<Instance, Self>(path, propValues)...
+    {}
+    explicit server(
+        sdbusplus::async::context& ctx, sdbusplus::bus_t& bus,
+        const sdbusplus::object_path& path,
+        typename Types<Instance, Self>::properties_t... propValues) :
+        context_ref(ctx), server_bus_ref(bus),
+        Types<Instance, Self>(path, propValues)...
+    {}
+
+    /** Limit the asynchronous method calls of each of the interfaces.
+     *
+     *  The limits apply to each interface separately, and should be set
+     *  before the server handles any calls.
+     */
+    void set_method_limits(const method_limits& limits)
+    {
+        (Types<Instance, Self>::set_method_limits(limits), ...);
+    }
+
+    /** Limit the asynchronous method calls of one of the interfaces. */
+    template <template <typename, typename> typename Type>
+    void set_method_limits(const method_limits& limits)
+    {
+        Type<Instance, Self>::set_method_limits(limits);
+    }
+
+    /** @return the method call counters, summed over the interfaces. */
+    auto get_method_stats() const -> method_stats
+    {
+        method_stats result{};
+        (add_method_stats(result,
+                          Types<Instance, Self>::get_method_stats()),
+         ...);
+        return result;
+    }
+
+  private:
+    static void add_method_stats(method_stats& sum, const method_stats& s)
+    {
+        sum.admitted += s.admitted;
+        sum.queued += s.queued;
+        sum.rejected += s.rejected;
+        sum.running += s.running;
+        sum.waiting += s.waiting;
+    }
 };
 
 } // namespace server
@@ -55,7 +170,8 @@ using server_t = server::server<Instance, Types...>;
 
 namespace server::details
 {
-/* Indirect so that the generated Types can access the server_t's context.
+/* Indirect so that the generated Types can access the server_t's context
+ * and bus.
  *
  * If P2893 gets into C++26 we could eliminate this because we can set all
  * the Types as friends directly.
@@ -67,8 +183,185 @@ struct server_context_friend
     {
         return std::launder(static_cast<Client*>(self))->ctx;
     }
+
+    template <typename Client, typename Self>
+    static sdbusplus::bus_t& bus(Self* self)
+    {
+        return std::launder(static_cast<Client*>(self))->serverBus;
+    }
 };
 
+class method_admission;
+
+/* An admitted (or rejected) method call, holding its place against the
+ * limits until it is destroyed. */
+class admitted_call
+{
+  public:
+    enum class decision
+    {
+        run,
+        queue,
+        reject,
+    };
+
+    admitted_call() = delete;
+    admitted_call(const admitted_call&) = delete;
+    admitted_call& operator=(const admitted_call&) = delete;
+    admitted_call& operator=(admitted_call&&) = delete;
+
+    admitted_call(method_admission& admission, decision state) noexcept :
+        admission(&admission), state(state)
+    {}
+    admitted_call(admitted_call&& other) noexcept :
+        admission(std::exchange(other.admission, nullptr)), state(other.state)
+    {}
+    ~admitted_call();
+
+    bool rejected() const noexcept
+    {
+        return state == decision::reject;
+    }
+
+    bool queued() const noexcept
+    {
+        return state == decision::queue;
+    }
+
+    /** Sender completing once a queued call may run. */
+    auto acquire() noexcept;
+
+  private:
+    method_admission* admission;
+    decision state;
+};
+
+/* The admission of the method calls of a generated interface. */
+class method_admission
+{
+  public:
+    method_admission() = default;
+    method_admission(const method_admission&) = delete;
+    method_admission& operator=(const method_admission&) = delete;
+    method_admission(method_admission&&) = delete;
+    method_admission& operator=(method_admission&&) = delete;
+
+    void set_limits(const method_limits& l)
+    {
+        limits = l;
+        permits.reset();
+        if (limits.max_concurrent > 0)
+        {
+            permits.emplace(limits.max_concurrent,
+                            "sdbusplus::async::server::method_admission");
+        }
+    }
+
+    /** Admit a call to run now, to wait for a permit, or reject it. */
+    auto admit() noexcept -> admitted_call
+    {
+        using decision = admitted_call::decision;
+
+        if (!permits || permits->try_acquire())
+        {
+            bump(admitted);
+            running.fetch_add(1, std::memory_order_relaxed);
+            return {*this, decision::run};
+        }
+
+        auto w = waiting.load(std::memory_order_relaxed);
+        do
+        {
+            if (w >= limits.max_queued)
+            {
+                bump(rejected);
+                return {*this, decision::reject};
+            }
+        } while (!waiting.compare_exchange_weak(w, w + 1,
+                                                std::memory_order_relaxed));
+
+        bump(admitted);
+        bump(queued);
+        return {*this, decision::queue};
+    }
+
+    auto get_stats() const noexcept -> method_stats
+    {
+        return {admitted.load(std::memory_order_relaxed),
+                queued.load(std::memory_order_relaxed),
+                rejected.load(std::memory_order_relaxed),
+                running.load(std::memory_order_relaxed),
+                waiting.load(std::memory_order_relaxed)};
+    }
+
+    friend admitted_call;
+
+  private:
+    static void bump(std::atomic<uint64_t>& counter) noexcept
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** A queued call has acquired its permit. */
+    void start_queued() noexcept
+    {
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+        running.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** A queued call was stopped before it ran. */
+    void abandon() noexcept
+    {
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /** A running call has finished. */
+    void release() noexcept
+    {
+        running.fetch_sub(1, std::memory_order_relaxed);
+        if (permits)
+        {
+            permits->release();
+        }
+    }
+
+    method_limits limits{};
+    std::optional<semaphore> permits{};
+
+    std::atomic<uint64_t> admitted{0};
+    std::atomic<uint64_t> queued{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> waiting{0};
+};
+
+inline admitted_call::~admitted_call()
+{
+    if (admission == nullptr)
+    {
+        return;
+    }
+
+    if (state == decision::run)
+    {
+        admission->release();
+    }
+    else if (state == decision::queue)
+    {
+        admission->abandon();
+    }
+}
+
+inline auto admitted_call::acquire() noexcept
+{
+    // Only running once acquired, since a waiting acquire may be stopped.
+    return admission->permits->acquire() |
+           execution::then([this]() noexcept {
+               admission->start_queued();
+               state = decision::run;
+           });
+}
+
 /* Determine if a type has a get_property call. */
 template <typename Tag, typename Instance>
 concept has_get_property_nomsg =
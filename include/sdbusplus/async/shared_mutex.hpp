@@ -0,0 +1,243 @@
+#pragma once
+
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/intrusive_queue.hpp>
+#include <sdbusplus/async/stoppable_operation.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace sdbusplus::async
+{
+
+namespace shared_mutex_ns
+{
+struct lock_completion;
+} // namespace shared_mutex_ns
+
+/** Which waiters a shared_mutex favors when it is contended. */
+enum class shared_mutex_preference
+{
+    /** New readers wait behind a waiting writer, so writers cannot starve. */
+    writers,
+    /** Readers share the lock whenever no writer holds it. */
+    readers,
+};
+
+/** An asynchronous reader/writer mutex.
+ *
+ *  Any number of tasks may hold the lock shared (`lock_shared`), or a single
+ *  task may hold it exclusively (`lock`).  The lock state is a single atomic
+ *  word, so locking and unlocking an uncontended mutex neither allocates nor
+ *  takes a system mutex; waiters are queued within their own operation state
+ *  and completed, in order, by the unlock which hands them the lock.
+ */
+class shared_mutex
+{
+  public:
+    shared_mutex(const shared_mutex&) = delete;
+    shared_mutex& operator=(const shared_mutex&) = delete;
+    shared_mutex(shared_mutex&&) = delete;
+    shared_mutex& operator=(shared_mutex&&) = delete;
+    ~shared_mutex() = default;
+
+    explicit shared_mutex(
+        const std::string& name = "sdbusplus::async::shared_mutex",
+        shared_mutex_preference preference = shared_mutex_preference::writers);
+
+    /** Sender completing once the lock is held exclusively. */
+    auto lock() noexcept;
+    /** Sender completing once the lock is held shared. */
+    auto lock_shared() noexcept;
+
+    bool try_lock() noexcept;
+    bool try_lock_shared() noexcept;
+
+    void unlock() noexcept;
+    void unlock_shared() noexcept;
+
+    friend shared_mutex_ns::lock_completion;
+
+  private:
+    static constexpr uint64_t writerBit = uint64_t{1} << 63;
+    static constexpr uint64_t waitingBit = uint64_t{1} << 62;
+
+    /** Queue a waiter, unless the lock can be taken right away. */
+    bool wait(shared_mutex_ns::lock_completion* c) noexcept;
+    /** Hand the lock to the waiters, once `held` has been released. */
+    void release(uint64_t held) noexcept;
+    /** Remove a waiter, for a stop request. */
+    bool cancel(shared_mutex_ns::lock_completion* c) noexcept;
+
+    std::string name;
+    shared_mutex_preference preference;
+
+    /** The number of readers, or writerBit, along with waitingBit when
+     *  the queue is non-empty. */
+    std::atomic<uint64_t> state{0};
+
+    std::mutex queueLock{};
+    details::intrusive_queue<shared_mutex_ns::lock_completion> waitingTasks{};
+    size_t waitingReaders = 0;
+    size_t waitingWriters = 0;
+};
+
+namespace shared_mutex_ns
+{
+
+struct lock_completion
+{
+    lock_completion() = delete;
+    lock_completion(const lock_completion&) = delete;
+    lock_completion& operator=(const lock_completion&) = delete;
+    lock_completion(lock_completion&&) = delete;
+    ~lock_completion() = default;
+
+    lock_completion(shared_mutex& mutexInstance, bool shared) noexcept :
+        mutexInstance(mutexInstance), shared(shared)
+    {}
+
+    friend shared_mutex;
+    friend details::intrusive_queue<lock_completion>;
+
+    void start() noexcept
+    {
+        if (shared ? mutexInstance.try_lock_shared() : mutexInstance.try_lock())
+        {
+            complete();
+            return;
+        }
+
+        if (mutexInstance.wait(this))
+        {
+            complete();
+        }
+    }
+
+  protected:
+    bool cancel() noexcept
+    {
+        return mutexInstance.cancel(this);
+    }
+
+  private:
+    virtual void complete() noexcept = 0;
+    virtual void stop() noexcept = 0;
+
+    shared_mutex& mutexInstance;
+    bool shared;
+    lock_completion* next = nullptr;
+    bool queued = false;
+};
+
+// Implementation (templated based on Receiver) of lock_completion.
+template <execution::receiver Receiver>
+struct lock_operation : details::stoppable_operation<lock_completion, Receiver>
+{
+    lock_operation(shared_mutex& mutexInstance, bool shared, Receiver r) :
+        details::stoppable_operation<lock_completion, Receiver>(
+            std::move(r), mutexInstance, shared)
+    {}
+
+  private:
+    void complete() noexcept override final
+    {
+        execution::set_value(std::move(this->receiver));
+    }
+};
+
+// shared_mutex sender
+struct lock_sender
+{
+    using sender_concept = execution::sender_t;
+
+    lock_sender() = delete;
+    lock_sender(shared_mutex& mutexInstance, bool shared) noexcept :
+        mutexInstance(mutexInstance), shared(shared)
+    {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<execution::set_value_t(),
+                                            execution::set_stopped_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> lock_operation<R>
+    {
+        return {mutexInstance, shared, std::move(r)};
+    }
+
+  private:
+    shared_mutex& mutexInstance;
+    bool shared;
+};
+
+/** RAII wrapper holding a shared_mutex for the duration of a scoped block.
+ *
+ *  @tparam Shared - Whether the lock is held shared or exclusively.
+ */
+template <bool Shared>
+class lock_guard
+{
+  public:
+    lock_guard() = delete;
+    lock_guard(const lock_guard&) = delete;
+    lock_guard& operator=(const lock_guard&) = delete;
+    lock_guard(lock_guard&&) = delete;
+    lock_guard& operator=(lock_guard&&) = delete;
+
+    explicit lock_guard(shared_mutex& mutexInstance) :
+        mutexInstance(mutexInstance)
+    {}
+
+    ~lock_guard()
+    {
+        unlock();
+    }
+
+    auto lock() noexcept
+    {
+        // Only owned once acquired, since a waiting lock may be cancelled.
+        return lock_sender{mutexInstance, Shared} |
+               execution::then([this]() noexcept { owned = true; });
+    }
+
+    void unlock() noexcept
+    {
+        if (owned)
+        {
+            if constexpr (Shared)
+            {
+                mutexInstance.unlock_shared();
+            }
+            else
+            {
+                mutexInstance.unlock();
+            }
+            owned = false;
+        }
+    }
+
+  private:
+    shared_mutex& mutexInstance;
+    bool owned = false;
+};
+
+} // namespace shared_mutex_ns
+
+using shared_lock_guard = shared_mutex_ns::lock_guard<true>;
+using unique_lock_guard = shared_mutex_ns::lock_guard<false>;
+
+inline auto shared_mutex::lock() noexcept
+{
+    return shared_mutex_ns::lock_sender{*this, false};
+}
+
+inline auto shared_mutex::lock_shared() noexcept
+{
+    return shared_mutex_ns::lock_sender{*this, true};
+}
+
+} // namespace sdbusplus::async
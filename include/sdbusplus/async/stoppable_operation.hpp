@@ -0,0 +1,71 @@
+#pragma once
+
+#include <sdbusplus/async/execution.hpp>
+
+#include <optional>
+#include <utility>
+
+namespace sdbusplus::async::details
+{
+
+/* Common start and stop handling of operations which wait in a queue.
+ *
+ * `Completion` provides the protected `start`, which queues the operation
+ * unless it completes right away, and `cancel`, which removes it from the
+ * queue and returns whether it was still queued.  A stop request cancels a
+ * queued operation and completes it as stopped.  A stop request racing with
+ * the start is ignored, and the operation waits as usual.
+ */
+template <typename Completion, execution::receiver R>
+struct stoppable_operation : Completion
+{
+    template <typename... Args>
+    explicit stoppable_operation(R r, Args&&... args) :
+        Completion(std::forward<Args>(args)...), receiver(std::move(r))
+    {}
+
+    void start() noexcept
+    {
+        auto token = execution::get_stop_token(execution::get_env(receiver));
+        if (token.stop_requested())
+        {
+            execution::set_stopped(std::move(receiver));
+            return;
+        }
+
+        // Register for stop requests before starting, since the operation
+        // may complete (and be destroyed) as soon as it is queued.
+        stop_callback.emplace(std::move(token), stop_requested{this});
+        Completion::start();
+    }
+
+  protected:
+    void stop() noexcept override final
+    {
+        execution::set_stopped(std::move(receiver));
+    }
+
+    R receiver;
+
+  private:
+    struct stop_requested
+    {
+        void operator()() noexcept
+        {
+            if (self->cancel())
+            {
+                execution::set_stopped(std::move(self->receiver));
+            }
+        }
+
+        stoppable_operation* self;
+    };
+
+    using stop_token_t = execution::stop_token_of_t<execution::env_of_t<R>>;
+
+    // Destroyed first, waiting for a concurrent stop request to finish.
+    std::optional<execution::stop_callback_for_t<stop_token_t, stop_requested>>
+        stop_callback{};
+};
+
+} // namespace sdbusplus::async::details
@@ -2,8 +2,16 @@
 
 #include <sdbusplus/async/context.hpp>
 #include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/timer_wheel.hpp>
 #include <sdbusplus/event.hpp>
 
+#include <exec/when_any.hpp>
+
+#include <chrono>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+
 namespace sdbusplus::async
 {
 
@@ -25,48 +33,88 @@ namespace timer_ns
 
 /* The sleep completion event.
  *
- * On start, creates the sd-event timer.
- * On callback, completes the Receiver.
+ * On start, adds a timer to the context's timer wheel.
+ * On expiry, completes the Receiver.
+ * On a stop request, removes the timer and completes as stopped.
  */
 template <execution::receiver R>
-struct sleep_operation : public context_ref, details::context_friend
+struct sleep_operation :
+    public context_ref,
+    details::context_friend,
+    details::timer_wheel::entry
 {
     sleep_operation() = delete;
     sleep_operation(sleep_operation&&) = delete;
 
-    sleep_operation(context& ctx, event_t::time_resolution time, R&& r) :
-        context_ref(ctx), time(time), receiver(std::move(r))
+    sleep_operation(context& ctx, details::timer_wheel::time_point deadline,
+                    R&& r) :
+        context_ref(ctx), details::timer_wheel::entry(&fire),
+        deadline(deadline), receiver(std::move(r))
     {}
 
-    static int handler(sd_event_source*, uint64_t, void* data) noexcept
+    ~sleep_operation()
     {
-        auto self = static_cast<sleep_operation<R>*>(data);
-        execution::set_value(std::move(self->receiver));
+        timers().cancel(*this);
+    }
 
-        return 0;
+    static void fire(details::timer_wheel::entry* e) noexcept
+    {
+        auto self = static_cast<sleep_operation<R>*>(e);
+        execution::set_value(std::move(self->receiver));
     }
 
     void start() noexcept
     {
+        auto token = execution::get_stop_token(execution::get_env(receiver));
+        if (token.stop_requested())
+        {
+            execution::set_stopped(std::move(receiver));
+            return;
+        }
+
+        // Register for stop requests before adding the timer, since the
+        // operation may complete (and be destroyed) as soon as it is added.
+        // A stop request racing with the add is ignored and the sleep
+        // completes normally.
+        stop_callback.emplace(std::move(token), stop_requested{this});
+
         try
         {
-            source = event_loop().add_oneshot_timer(handler, this, time);
+            timers().add(*this, deadline);
         }
         catch (...)
         {
+            timers().cancel(*this);
             execution::set_error(std::move(receiver), std::current_exception());
         }
     }
 
   private:
-    event_t& event_loop()
+    struct stop_requested
+    {
+        void operator()() noexcept
+        {
+            if (self->timers().cancel(*self))
+            {
+                execution::set_stopped(std::move(self->receiver));
+            }
+        }
+
+        sleep_operation* self;
+    };
+
+    details::timer_wheel& timers()
     {
-        return get_event_loop(ctx);
+        return get_timer_wheel(ctx);
     }
 
-    event_t::time_resolution time;
-    event_source_t source;
+    using stop_token_t =
+        execution::stop_token_of_t<execution::env_of_t<R>>;
+
+    details::timer_wheel::time_point deadline;
     R receiver;
+    std::optional<execution::stop_callback_for_t<stop_token_t, stop_requested>>
+        stop_callback{};
 };
 
 /** The delay Sender.
@@ -79,8 +127,9 @@ struct sleep_sender : public context_ref, details::context_friend
 
     sleep_sender() = delete;
 
-    sleep_sender(context& ctx, event_t::time_resolution time) noexcept :
-        context_ref(ctx), time(time)
+    sleep_sender(context& ctx,
+                 details::timer_wheel::time_point deadline) noexcept :
+        context_ref(ctx), deadline(deadline)
     {}
 
     template <typename Self, class... Env>
@@ -93,20 +142,21 @@ struct sleep_sender : public context_ref, details::context_friend
     template <execution::receiver R>
     auto connect(R r) -> sleep_operation<R>
     {
-        return {ctx, time, std::move(r)};
+        return {ctx, deadline, std::move(r)};
     }
 
-    static auto sleep_for(context& ctx, event_t::time_resolution time)
+    static auto sleep_until(context& ctx,
+                            details::timer_wheel::time_point deadline)
     {
         // Run the delay sender and then switch back to the worker thread.
         // The delay completion happens from the sd-event handler, which is
         // ran on the 'caller' thread.
-        return execution::continues_on(sleep_sender(ctx, time),
+        return execution::continues_on(sleep_sender(ctx, deadline),
                                        get_scheduler(ctx));
     }
 
   private:
-    event_t::time_resolution time;
+    details::timer_wheel::time_point deadline;
 };
 
 } // namespace timer_ns
@@ -114,7 +164,111 @@ struct sleep_sender : public context_ref, details::context_friend
 template <typename Rep, typename Period>
 auto sleep_for(context& ctx, std::chrono::duration<Rep, Period> time)
 {
-    return timer_ns::sleep_sender::sleep_for(
-        ctx, std::chrono::duration_cast<event_t::time_resolution>(time));
+    return timer_ns::sleep_sender::sleep_until(
+        ctx, details::timer_wheel::now() +
+                 std::chrono::duration_cast<event_t::time_resolution>(time));
+}
+
+class timeout_exception : public std::runtime_error
+{
+  public:
+    timeout_exception() : std::runtime_error("Timeout") {}
+};
+
+/** with_timeout Sender
+ *
+ *  Runs `sender`, failing with `timeout_exception` if it does not complete
+ *  within `time`.  On expiry, the Sender is sent a stop request and the
+ *  timeout is reported once it completes, so it must support stop requests
+ *  to be interrupted: `sleep_for`, `match`, `fdio_mux` and the waits of
+ *  `mutex`, `shared_mutex`, `semaphore` and `channel` all do.  Likewise, a
+ *  Sender completing first stops the timeout, which is a timer wheel entry
+ *  rather than an sd-event source.
+ *
+ *  ```
+ *      auto msg = co_await with_timeout(ctx, m.next(), 5s);
+ *  ```
+ *
+ *  @param[in] ctx The async context.
+ *  @param[in] sender The Sender to run.
+ *  @param[in] time The length of time to allow.
+ *
+ *  @return A sender which completes as `sender`, or with a
+ *          `timeout_exception` after time.
+ */
+template <execution::sender S, typename Rep, typename Period>
+auto with_timeout(context& ctx, S&& sender,
+                  std::chrono::duration<Rep, Period> time)
+{
+    return exec::when_any(
+        std::forward<S>(sender),
+        sleep_for(ctx, time) | execution::let_value([]() {
+            return execution::just_error(
+                std::make_exception_ptr(timeout_exception()));
+        }));
 }
+
+/** A periodic timer.
+ *
+ *  Unlike a loop of `sleep_for`, the ticks are kept at fixed multiples of the
+ *  interval from the construction of the timer, so the time spent handling
+ *  each tick does not accumulate as drift.  If a tick is handled late, the
+ *  next one completes immediately and any further ticks missed meanwhile are
+ *  skipped.
+ *
+ *  ```
+ *      auto timer = periodic(ctx, 100ms);
+ *      while (!ctx.stop_requested())
+ *      {
+ *          co_await timer.next();
+ *          sample();
+ *      }
+ *  ```
+ */
+class periodic : public context_ref, details::context_friend
+{
+  public:
+    using time_point = details::timer_wheel::time_point;
+
+    template <typename Rep, typename Period>
+    periodic(context& ctx, std::chrono::duration<Rep, Period> interval) :
+        context_ref(ctx),
+        interval(std::chrono::duration_cast<time_point>(interval)),
+        deadline(details::timer_wheel::now() + this->interval)
+    {
+        if (this->interval <= time_point::zero())
+        {
+            throw std::invalid_argument("periodic interval must be positive");
+        }
+    }
+
+    /** Get a Sender which completes at the next tick. */
+    auto next()
+    {
+        auto when = deadline;
+        auto now = details::timer_wheel::now();
+
+        int64_t ticks = 1;
+        if (now >= deadline)
+        {
+            ticks += (now - deadline) / interval;
+        }
+        skipped_ticks += static_cast<uint64_t>(ticks - 1);
+        deadline += ticks * interval;
+
+        return timer_ns::sleep_sender::sleep_until(ctx, when);
+    }
+
+    /** The number of ticks skipped because they were handled late. */
+    uint64_t skipped() const noexcept
+    {
+        return skipped_ticks;
+    }
+
+  private:
+    time_point interval;
+    time_point deadline;
+    uint64_t skipped_ticks = 0;
+};
+
 } // namespace sdbusplus::async
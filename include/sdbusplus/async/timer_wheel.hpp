@@ -0,0 +1,110 @@
+#pragma once
+
+#include <sdbusplus/event.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace sdbusplus::async::details
+{
+
+/** A hierarchical timer wheel shared by all the timers of a context.
+ *
+ *  Timers are kept in 4 levels of 64 slots, with a resolution of one
+ *  millisecond at the lowest level and each level covering 64 times the
+ *  span of the one below.  Adding and cancelling a timer is O(1) and, no
+ *  matter how many timers are pending, only a single sd-event timer source
+ *  exists, armed for the earliest slot which needs attention.
+ *
+ *  Timers may be added and cancelled from any thread.  The sd-event timer
+ *  is only re-armed with the sd-event lock held; a thread adding a timer
+ *  earlier than the armed time submits the re-arm to the sd-event thread
+ *  instead of waiting for the lock.
+ */
+class timer_wheel
+{
+  public:
+    /** Time since boot (CLOCK_BOOTTIME). */
+    using time_point = event_t::time_resolution;
+
+    /** A timer on the wheel.
+     *
+     *  The owner provides the `fire` function and must keep the entry alive
+     *  until it has fired or has been cancelled.
+     */
+    struct entry
+    {
+        explicit entry(void (*fire)(entry*) noexcept) : fire(fire) {}
+        entry(const entry&) = delete;
+        entry& operator=(const entry&) = delete;
+
+        void (*fire)(entry*) noexcept;
+
+      private:
+        friend timer_wheel;
+
+        entry* prev = nullptr;
+        entry* next = nullptr;
+        uint64_t expiry = 0;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool linked = false;
+    };
+
+    explicit timer_wheel(event_t& event);
+    timer_wheel(const timer_wheel&) = delete;
+    timer_wheel& operator=(const timer_wheel&) = delete;
+    ~timer_wheel() = default;
+
+    /** The current time, in the clock used by the wheel. */
+    static time_point now();
+
+    /** Schedule `e` to fire at `when`; it fires no earlier than that. */
+    void add(entry& e, time_point when);
+
+    /** Remove `e` from the wheel.
+     *
+     *  @return true if the entry was pending and now will not fire, false if
+     *          it has already fired or is about to.
+     */
+    bool cancel(entry& e);
+
+  private:
+    static constexpr unsigned slot_bits = 6;
+    static constexpr unsigned slots = 1 << slot_bits;
+    static constexpr unsigned levels = 4;
+    static constexpr uint64_t tick_usec = 1000;
+    static constexpr uint64_t never = UINT64_MAX;
+
+    void insert(entry& e);
+    void unlink(entry& e);
+    uint64_t next_tick() const;
+    entry* advance(uint64_t target);
+    // Arm the sd-event timer for the next tick; only called from the
+    // sd-event callbacks, with the sd-event lock held.
+    void rearm();
+
+    static int timer_handler(sd_event_source*, uint64_t, void*) noexcept;
+    static void wake_handler(void*) noexcept;
+
+    std::mutex lock{};
+
+    /** The tick the wheel has been advanced to. */
+    uint64_t current = 0;
+    /** The tick the sd-event timer is armed for, or `never`. */
+    uint64_t armed = never;
+    /** Whether a re-arm has been submitted to the sd-event thread. */
+    bool wake_pending = false;
+
+    std::array<std::array<entry*, slots>, levels> wheel{};
+    /** Bit-mask of non-empty slots, per level. */
+    std::array<uint64_t, levels> occupied{};
+
+    event_t& event;
+    event_source_t timer;
+    event_submission_t wake;
+};
+
+} // namespace sdbusplus::async::details
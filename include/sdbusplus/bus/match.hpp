@@ -3,6 +3,7 @@
 #include <systemd/sd-bus.h>
 
 #include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match_mux.hpp>
 #include <sdbusplus/message.hpp>
 #include <sdbusplus/slot.hpp>
 
@@ -42,9 +43,27 @@ struct match : private sdbusplus::details::bus_friend
         match(bus, _match.c_str(), std::move(callback))
     {}
 
+    /** Tag for the constructor registering through the bus' match_mux. */
+    struct shared_t
+    {
+        explicit shared_t() = default;
+    };
+    static constexpr shared_t shared{};
+
+    /** @brief Register a signal match, sharing the dbus-daemon registration
+     *         with the other shared matches of the bus (see match_mux).
+     *
+     *  @param[in] bus - The bus to register on.
+     *  @param[in] match - The match to register.
+     *  @param[in] callback - The callback for matches.
+     */
+    match(sdbusplus::bus_t& bus, const std::string& _match, callback_t callback,
+          shared_t);
+
   private:
     std::unique_ptr<callback_t> _callback;
     slot_t _slot;
+    bus::match_mux::subscription _subscription;
 };
 
 /** Utilities for defining match rules based on the DBus specification */
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/message.hpp>
+#include <sdbusplus/slot.hpp>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sdbusplus::bus
+{
+
+/** A parsed match rule, as a set of key/value pairs. */
+struct match_rule
+{
+    /** Parse a rule string, such as those built with `match_rules`. */
+    static match_rule parse(std::string_view rule);
+
+    /** Does every message matched by `narrow` also match this rule?
+     *
+     *  Only true if the keys `narrow` adds can be checked by `matches`, so
+     *  that the messages of this rule can be filtered down to `narrow`.
+     */
+    bool subsumes(const match_rule& narrow) const;
+
+    /** Check the locally-checkable keys of the rule against a message.
+     *
+     *  @param[in] m - The message.
+     *  @param[in] arg0 - The first argument of the message, if a string.
+     */
+    bool matches(message_t& m, const std::string* arg0) const;
+
+    /** The value of `key`, or nullptr. */
+    const std::string* find(const std::string& key) const;
+
+    std::map<std::string, std::string> keys{};
+};
+
+/** A per-bus multiplexer of signal match rules.
+ *
+ *  Each `sd_bus_add_match` installs a rule in the dbus-daemon, which then
+ *  matches every message against it, and sd-bus re-filters every received
+ *  message against each match.  The multiplexer registers each rule once,
+ *  no matter how many subscribers it has, and a rule subsumed by an already
+ *  registered one (for example, the same rule with an added `path` or
+ *  `arg0`) does not need a registration of its own.  When a broader rule is
+ *  added, the registrations it subsumes are folded into it.
+ *
+ *  Messages are dispatched to the subscribers of a registration through
+ *  indexes on their `path`, `arg0`, `member` or `interface`, and checked
+ *  against their own rule.  Keys which
+ *  cannot be checked locally (such as `sender`, which the daemon matches
+ *  against well-known names) prevent sharing a registration unless both
+ *  rules have the same value.
+ *
+ *  A registration lives until its last subscriber is removed, so narrower
+ *  subscribers which were folded into a broader rule keep receiving through
+ *  it even after the broader subscribers are gone.
+ */
+class match_mux :
+    public std::enable_shared_from_this<match_mux>,
+    private sdbusplus::details::bus_friend
+{
+  public:
+    using callback_t = std::function<void(message_t&)>;
+
+  private:
+    struct subscriber;
+    struct registration;
+
+  public:
+    /** RAII handle of a subscription, removing it on destruction. */
+    class subscription
+    {
+      public:
+        subscription() = default;
+        subscription(const subscription&) = delete;
+        subscription& operator=(const subscription&) = delete;
+        subscription(subscription&&) = default;
+        subscription& operator=(subscription&&);
+        ~subscription();
+
+        explicit operator bool() const
+        {
+            return sub != nullptr;
+        }
+
+      private:
+        friend match_mux;
+
+        subscription(std::shared_ptr<match_mux> mux,
+                     std::shared_ptr<subscriber> sub) :
+            mux(std::move(mux)), sub(std::move(sub))
+        {}
+
+        void reset();
+
+        std::shared_ptr<match_mux> mux{};
+        std::shared_ptr<subscriber> sub{};
+    };
+
+    explicit match_mux(bus_t& bus);
+    match_mux(const match_mux&) = delete;
+    match_mux& operator=(const match_mux&) = delete;
+    ~match_mux() = default;
+
+    /** Get the multiplexer of a bus, creating it if needed. */
+    static std::shared_ptr<match_mux> get(bus_t& bus);
+
+    /** Subscribe `callback` to the messages matching `rule`. */
+    subscription add(std::string_view rule, callback_t callback);
+
+    /** The number of rules registered with the dbus-daemon. */
+    size_t registrations();
+
+  private:
+    struct subscriber
+    {
+        match_rule rule;
+        callback_t callback;
+        /** Whether `rule` is identical to its registration's, so that it
+         *  needs no local check. */
+        bool exact = false;
+        std::atomic<bool> active = true;
+        registration* owner = nullptr;
+    };
+
+    struct registration : std::enable_shared_from_this<registration>
+    {
+        std::string rule_string;
+        match_rule rule;
+        slot_t slot{};
+        match_mux* mux = nullptr;
+
+        /** The keys subscribers are indexed on, most selective first.  A
+         *  subscriber is indexed on the first of them in its rule only, so
+         *  that it is found once per message. */
+        static constexpr std::array<const char*, 4> index_keys = {
+            "path", "arg0", "member", "interface"};
+
+        /** Subscribers by the value of their indexed key, per key. */
+        std::array<std::unordered_multimap<std::string,
+                                           std::shared_ptr<subscriber>>,
+                   index_keys.size()>
+            indexes{};
+        /** Subscribers with none of the indexed keys. */
+        std::vector<std::shared_ptr<subscriber>> others{};
+
+        /** The index of a rule's subscribers, and the value of its key, or
+         *  `index_keys.size()` if none. */
+        static auto index_of(const match_rule& rule)
+            -> std::pair<size_t, const std::string*>;
+
+        void insert(const std::shared_ptr<subscriber>& s);
+        void erase(const subscriber* s);
+        bool empty() const;
+    };
+
+    void remove(const std::shared_ptr<subscriber>& s);
+
+    static int handler(sd_bus_message* m, void* data, sd_bus_error*) noexcept;
+    void dispatch(registration& r, sd_bus_message* m);
+
+    bus_t bus;
+    std::mutex lock{};
+    std::vector<std::shared_ptr<registration>> registered{};
+};
+
+} // namespace sdbusplus::bus
@@ -2,8 +2,10 @@
 
 #include <systemd/sd-event.h>
 
+#include <atomic>
 #include <chrono>
 #include <mutex>
+#include <thread>
 #include <utility>
 
 namespace sdbusplus
@@ -77,6 +79,34 @@ class condition
     int fd = -1;
 };
 
+/** An operation to be applied by the thread running the run-loop.
+ *
+ *  Queued with `event::submit`, without taking the run-loop lock.  The
+ *  handler is called with the run-loop lock held, so it may manipulate
+ *  sd-event sources directly, but only through the primitives for a caller
+ *  holding the lock (such as `event::arm_timer_locked`): it must not create
+ *  or destroy sources, or call anything else which takes the lock.  The
+ *  owner must keep the submission alive until the handler has been called,
+ *  after which it may be submitted again.
+ */
+class submission
+{
+  public:
+    friend event;
+
+    using handler_t = void (*)(void* data) noexcept;
+
+    submission(handler_t handler, void* data) : handler(handler), data(data)
+    {}
+    submission(const submission&) = delete;
+    submission& operator=(const submission&) = delete;
+
+  private:
+    handler_t handler;
+    void* data;
+    submission* next = nullptr;
+};
+
 /** sd-event based run-loop implementation.
  *
  *  This is sd-event is thread-safe in the sense that one thread may be
@@ -90,7 +120,28 @@ class event
   public:
     using time_resolution = std::chrono::microseconds;
 
+    /** Counters of the iterations of the run-loop. */
+    struct stats
+    {
+        /** Number of iterations which dispatched sources. */
+        uint64_t dispatches = 0;
+        /** Total time spent dispatching sources. */
+        std::chrono::nanoseconds dispatch_time{};
+        /** Longest time spent dispatching the sources of one iteration. */
+        std::chrono::nanoseconds max_dispatch_time{};
+    };
+
     event();
+    /** Share an existing sd_event, such as the default event of the thread
+     *  (see sd_event_default), so that its other sources are dispatched by
+     *  `run_one` along with those added here.
+     *
+     *  A reference is taken on the sd_event.  The loop must only be run
+     *  through this object, and the other users of the sd_event must only
+     *  use it from the thread running `run_one`, such as from their own
+     *  callbacks.
+     */
+    explicit event(sd_event* e);
     event(const event&) = delete;
     event(event&& e) = delete;
 
@@ -99,8 +150,24 @@ class event
         sd_event_unref(eventp);
     }
 
+    /** Get the underlying sd_event. */
+    sd_event* get() noexcept
+    {
+        return eventp;
+    }
+
     /** Execute a single iteration of the run-loop (see sd_event_run). */
     void run_one(time_resolution timeout = time_resolution::max());
+
+    /** Get the iteration counters; safe to call from any thread. */
+    stats get_stats() const noexcept
+    {
+        return {stat_dispatches.load(std::memory_order_relaxed),
+                std::chrono::nanoseconds(
+                    stat_dispatch_time.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(
+                    stat_max_dispatch_time.load(std::memory_order_relaxed))};
+    }
     /** Force a pending `run_one` to exit. */
     void break_run();
 
@@ -108,6 +175,18 @@ class event
     source add_io(int fd, uint32_t events, sd_event_io_handler_t handler,
                   void* data);
 
+    /** Queue an operation for the thread running `run_one`.
+     *
+     *  The submission is pushed onto a lock-free queue, which `run_one`
+     *  applies before each sd_event_run.  If no thread holds the run-loop
+     *  lock, the queue is applied immediately by the caller instead.  The
+     *  running `run_one` is woken only by the first submission of a batch,
+     *  and the caller never waits for the lock.  Handlers may be called from
+     *  within `run_one` or `submit`; taking the lock from one is a bug,
+     *  asserted by `obtain_lock`.
+     */
+    void submit(submission& s);
+
     /** Add a eventfd-based sdbusplus::event::condition to the run-loop. */
     condition add_condition(sd_event_io_handler_t handler, void* data);
 
@@ -116,11 +195,34 @@ class event
         sd_event_time_handler_t handler, void* data, time_resolution time,
         time_resolution accuracy = std::chrono::milliseconds(1));
 
+    /** Add a timer source which does not fire until set with `arm_timer`. */
+    source add_timer(sd_event_time_handler_t handler, void* data,
+                     time_resolution accuracy = std::chrono::milliseconds(1));
+
+    /** Set a timer source to fire once, at an absolute CLOCK_BOOTTIME time.
+     */
+    void arm_timer(source& s, time_resolution time);
+
+    /** As `arm_timer`, for a caller which holds the run-loop lock: an
+     *  sd-event callback or a submission handler.
+     */
+    void arm_timer_locked(source& s, time_resolution time);
+
+    /** Does the calling thread hold the run-loop lock? */
+    bool holds_lock() const noexcept
+    {
+        return owner.load(std::memory_order_relaxed) ==
+               std::this_thread::get_id();
+    }
+
     friend source;
 
   private:
     static int run_wakeup(sd_event_source*, int, uint32_t, void*);
 
+    // Apply the queued submissions; called with the lock held.
+    void apply_submissions();
+
     sd_event* eventp = nullptr;
 
     // Condition to allow 'break_run' to exit the run-loop.
@@ -133,14 +235,60 @@ class event
     // recursive_mutex to allow this.
     std::recursive_mutex lock{};
 
+    // The lock, recording the thread holding it for `holds_lock`.
+    class held_lock
+    {
+      public:
+        held_lock(event& e, std::unique_lock<std::recursive_mutex> l) noexcept :
+            ev(e), l(std::move(l)), outermost(!e.holds_lock())
+        {
+            if (outermost)
+            {
+                ev.owner.store(std::this_thread::get_id(),
+                               std::memory_order_relaxed);
+            }
+        }
+        held_lock(const held_lock&) = delete;
+        held_lock& operator=(const held_lock&) = delete;
+
+        ~held_lock()
+        {
+            if (outermost)
+            {
+                ev.owner.store({}, std::memory_order_relaxed);
+            }
+        }
+
+      private:
+        event& ev;
+        std::unique_lock<std::recursive_mutex> l;
+        bool outermost;
+    };
+
+    // The thread holding the lock, if any.
+    std::atomic<std::thread::id> owner{};
+
     // Safely get the lock, possibly signaling the running 'run_one' to exit.
+    // A thread already holding it (such as from an sd-event callback) takes
+    // it again directly.
     template <bool Signal = true>
-    std::unique_lock<std::recursive_mutex> obtain_lock();
+    held_lock obtain_lock();
     // When obtain_lock signals 'run_one' to exit, we want a priority of
     // obtaining the lock so that the 'run_one' task doesn't run and reclaim
     // the lock before the signaller can run.  This stage is first obtained
     // prior to getting the primary lock in order to set an order.
     std::mutex obtain_lock_stage{};
+
+    // Submissions waiting to be applied, most recent first.
+    std::atomic<submission*> submissions{nullptr};
+    // Set, under the lock, while submission handlers are being called.
+    bool applying = false;
+
+    // Counters for `get_stats`, only updated under the lock; the times are
+    // in nanoseconds.
+    std::atomic<uint64_t> stat_dispatches{0};
+    std::atomic<uint64_t> stat_dispatch_time{0};
+    std::atomic<uint64_t> stat_max_dispatch_time{0};
 };
 
 } // namespace event
@@ -148,5 +296,6 @@ class event
 using event_t = event::event;
 using event_source_t = event::source;
 using event_cond_t = event::condition;
+using event_submission_t = event::submission;
 
 } // namespace sdbusplus
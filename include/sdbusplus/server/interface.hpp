@@ -1,13 +1,21 @@
 #pragma once
 
 #include <systemd/sd-bus.h>
+#include <systemd/sd-event.h>
 
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/sdbus.hpp>
+#include <sdbusplus/server/signal_policy.hpp>
 #include <sdbusplus/slot.hpp>
 #include <sdbusplus/vtable.hpp>
 
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <type_traits>
 
 namespace sdbusplus
 {
@@ -81,6 +89,77 @@ struct interface final : private sdbusplus::details::bus_friend
      */
     void property_changed(const char* property);
 
+    /** @brief Broadcast a property changed signal, subject to the
+     *         signal_policy of the property, if it has one.
+     *
+     *  @param[in] property - The property which changed.
+     *  @param[in] value - The new value of the property.
+     */
+    template <typename T>
+    void property_changed(const char* property, const T& value)
+    {
+        if (_signal_throttles.empty())
+        {
+            property_changed(property);
+            return;
+        }
+
+        std::optional<double> numeric{};
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            numeric = static_cast<double>(value);
+        }
+        property_changed_throttled(property, numeric);
+    }
+
+    /** @brief Limit the PropertiesChanged signals sent for a property.
+     *
+     *  Deferred signals are sent from the timer set by set_signal_timer(),
+     *  or otherwise from the sd-event loop the bus is attached to.  If
+     *  there is neither, they are only sent by calls to flush_signals().
+     *
+     *  @param[in] property - The property to apply the policy to.
+     *  @param[in] policy - The policy.
+     */
+    void set_signal_policy(const char* property, const signal_policy& policy);
+
+    /** @brief Callable which sends any deferred signals that are due, if
+     *         the interface still exists.
+     */
+    class signal_flush
+    {
+      public:
+        explicit signal_flush(std::weak_ptr<interface*> target) :
+            target(std::move(target))
+        {}
+
+        void operator()() const
+        {
+            if (auto t = target.lock())
+            {
+                (*t)->flush_signals();
+            }
+        }
+
+      private:
+        std::weak_ptr<interface*> target;
+    };
+
+    /** @brief Function which arranges for a signal_flush to be called after
+     *         a delay, on the thread which owns the interface.
+     */
+    using signal_timer_t =
+        std::function<void(std::chrono::microseconds, signal_flush)>;
+
+    /** @brief Set the timer used to send deferred signals. */
+    void set_signal_timer(signal_timer_t&& timer)
+    {
+        _signal_timer = std::move(timer);
+    }
+
+    /** @brief Send any deferred signals which are due. */
+    void flush_signals();
+
     /** @brief Emit the interface is added on D-Bus */
     void emit_added()
     {
@@ -111,11 +190,22 @@ struct interface final : private sdbusplus::details::bus_friend
     }
 
   private:
+    void property_changed_throttled(const char* property,
+                                    std::optional<double> value);
+    void arm_signal_timer();
+    static int signal_timer_handler(sd_event_source*, uint64_t, void*);
+
     bus_t _bus;
     std::string _path;
     std::string _interf;
     bool _interface_added;
     slot_t _slot;
+
+    std::map<std::string, signal_throttle, std::less<>> _signal_throttles;
+    signal_timer_t _signal_timer;
+    std::optional<signal_throttle::clock::time_point> _signal_deadline;
+    sd_event_source* _signal_source = nullptr;
+    std::shared_ptr<interface*> _signal_self;
 };
 
 } // namespace interface
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+
+namespace sdbusplus
+{
+namespace server
+{
+
+/** @struct signal_policy
+ *  @brief Limits on how often PropertiesChanged is sent for a property.
+ *
+ *  The stored value of the property is always updated exactly; only the
+ *  signal traffic is reduced.  A zero member disables that limit.
+ */
+struct signal_policy
+{
+    /** Changes smaller than this (numeric properties only) are not signalled.
+     */
+    double absolute_deadband = 0.0;
+    /** Changes smaller than this fraction of the last signalled value
+     *  (numeric properties only) are not signalled. */
+    double relative_deadband = 0.0;
+    /** Minimum time between two signals.  A change arriving sooner is sent
+     *  once the interval has passed, with the value current at that time. */
+    std::chrono::microseconds min_interval{0};
+    /** Maximum time a change suppressed by the deadband may go unsignalled.
+     */
+    std::chrono::microseconds max_staleness{0};
+};
+
+/** @class signal_throttle
+ *  @brief Tracks the signalling state of one property under a signal_policy.
+ *
+ *  The owner reports every change of the property with changed(), which
+ *  indicates whether a signal should be sent right away.  When it should
+ *  not, deadline() gives the time at which the owner must call expired() to
+ *  send the deferred (trailing) signal.
+ */
+class signal_throttle
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    explicit signal_throttle(const signal_policy& policy) : policy(policy) {}
+
+    /** @brief Record a change to the property.
+     *
+     *  @param[in] value - The new value, for numeric properties.
+     *  @param[in] now - The current time.
+     *
+     *  @return true if a signal should be sent now.
+     */
+    bool changed(std::optional<double> value, clock::time_point now)
+    {
+        current = value;
+
+        if (!last_signal)
+        {
+            signalled(now);
+            return true;
+        }
+
+        if (!significant())
+        {
+            pending = (current != last_value);
+            return false;
+        }
+
+        if (now < *last_signal + policy.min_interval)
+        {
+            pending = true;
+            return false;
+        }
+
+        signalled(now);
+        return true;
+    }
+
+    /** @brief The time a deferred signal is due, if there is one. */
+    std::optional<clock::time_point> deadline() const
+    {
+        if (!pending || !last_signal)
+        {
+            return std::nullopt;
+        }
+
+        if (significant())
+        {
+            return *last_signal + policy.min_interval;
+        }
+
+        if (policy.max_staleness.count() == 0)
+        {
+            return std::nullopt;
+        }
+        return *last_signal + std::max(policy.max_staleness,
+                                       policy.min_interval);
+    }
+
+    /** @brief Check for a deferred signal which is now due.
+     *
+     *  @param[in] now - The current time.
+     *
+     *  @return true if a signal should be sent now.
+     */
+    bool expired(clock::time_point now)
+    {
+        auto due = deadline();
+        if (!due || (now < *due))
+        {
+            return false;
+        }
+
+        signalled(now);
+        return true;
+    }
+
+  private:
+    /** Is the current value outside the deadband of the last signal? */
+    bool significant() const
+    {
+        if (!current || !last_value)
+        {
+            return true;
+        }
+
+        auto delta = std::abs(*current - *last_value);
+        if (delta < policy.absolute_deadband)
+        {
+            return false;
+        }
+        if (delta < (policy.relative_deadband * std::abs(*last_value)))
+        {
+            return false;
+        }
+        return true;
+    }
+
+    void signalled(clock::time_point now)
+    {
+        last_signal = now;
+        last_value = current;
+        pending = false;
+    }
+
+    signal_policy policy;
+
+    std::optional<double> current{};
+    std::optional<double> last_value{};
+    std::optional<clock::time_point> last_signal{};
+    bool pending = false;
+};
+
+} // namespace server
+} // namespace sdbusplus
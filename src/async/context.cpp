@@ -4,15 +4,35 @@
 #include <sdbusplus/async/task.hpp>
 #include <sdbusplus/async/timer.hpp>
 
+#include <algorithm>
 #include <chrono>
 
 namespace sdbusplus::async
 {
 
-context::context(bus_t&& b) : bus(std::move(b))
+context::context(bus_t&& b, context_options o) :
+    bus(std::move(b)), options(o),
+    frames(o.frame_pool_retain
+               ? details::frame_pool::create(o.frame_pool_retain)
+               : nullptr),
+    event_loop(o.event ? event_t(o.event) : event_t()),
+    loop(o.starvation_limit)
 {
     dbus_source =
         event_loop.add_io(bus.get_fd(), EPOLLIN, dbus_event_handle, this);
+
+    if (options.single_thread)
+    {
+        // Tasks scheduled from other threads while the caller is waiting on
+        // the sd-events need to interrupt the wait.  Tasks scheduled by the
+        // sd-event handlers themselves do not: the wait is already over.
+        loop.set_wakeup([this]() {
+            if (std::this_thread::get_id() != single_thread_id)
+            {
+                event_loop.break_run();
+            }
+        });
+    }
 }
 
 namespace details
@@ -97,8 +117,10 @@ auto wait_process_completion::loop(context& ctx) -> task<>
     {
         // Handle the next sdbus event.  Completion likely happened on a
         // different thread so we need to transfer back to the worker thread.
-        co_await execution::continues_on(wait_process_sender(ctx),
-                                         ctx.loop.get_scheduler());
+        // The processing is ahead of the ordinary tasks, for the replies and
+        // method calls to be dispatched promptly under load.
+        co_await execution::continues_on(
+            wait_process_sender(ctx), ctx.loop.get_scheduler(priority::high));
     }
 
     {
@@ -107,6 +129,201 @@ auto wait_process_completion::loop(context& ctx) -> task<>
     }
 }
 
+/* A bus attached to the context, besides the primary bus.
+ *
+ * The bus is processed on the worker by its own loop task, which waits
+ * between batches for the bus' fd to become readable, or for its earliest
+ * method-call timeout on the context's timer wheel.  The fd is watched
+ * edge-triggered; readiness signalled while the loop is busy processing is
+ * kept in `ready`, so the next wait completes right away.
+ */
+struct attached_bus :
+    context_ref,
+    sdbusplus::details::bus_friend,
+    timer_wheel::entry
+{
+    struct completion
+    {
+        virtual ~completion() = default;
+        virtual void complete() noexcept = 0;
+    };
+
+    attached_bus(context& ctx, bus_t&& b) :
+        context_ref(ctx), timer_wheel::entry(&timeout_fired),
+        bus(std::move(b)),
+        source(ctx.event_loop.add_io(bus.get_fd(), EPOLLIN | EPOLLET,
+                                     io_handler, this))
+    {}
+
+    attached_bus(const attached_bus&) = delete;
+    attached_bus& operator=(const attached_bus&) = delete;
+
+    ~attached_bus()
+    {
+        ctx.timers.cancel(*this);
+    }
+
+    /** Wait for the bus to need processing, then complete `c`. */
+    void wait(completion* c) noexcept
+    {
+        {
+            std::lock_guard l{lock};
+            if (!std::exchange(ready, false) && !stopped)
+            {
+                waiting = c;
+                return;
+            }
+        }
+        c->complete();
+    }
+
+    /** Mark the bus as needing processing, resuming the loop. */
+    void wake(bool stop = false) noexcept
+    {
+        completion* c = nullptr;
+        {
+            std::lock_guard l{lock};
+            stopped = stopped || stop;
+            c = std::exchange(waiting, nullptr);
+            if (c == nullptr)
+            {
+                ready = true;
+            }
+        }
+
+        if (c != nullptr)
+        {
+            c->complete();
+        }
+    }
+
+    /** Arm the timer for the earliest method-call timeout of the bus. */
+    void arm_timeout()
+    {
+        ctx.timers.cancel(*this);
+
+        // sd_bus_get_timeout returns an absolute CLOCK_MONOTONIC time, or
+        // UINT64_MAX when nothing is pending.
+        uint64_t to_usec = 0;
+        sd_bus_get_timeout(get_busp(bus), &to_usec);
+        if (to_usec == UINT64_MAX)
+        {
+            return;
+        }
+
+        auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+        auto delay = std::max(std::chrono::microseconds(to_usec) - now,
+                              std::chrono::microseconds::zero());
+
+        ctx.timers.add(*this, timer_wheel::now() + delay);
+    }
+
+    static int io_handler(sd_event_source*, int, uint32_t, void* data)
+    {
+        static_cast<attached_bus*>(data)->wake();
+        return 0;
+    }
+
+    static void timeout_fired(timer_wheel::entry* e) noexcept
+    {
+        static_cast<attached_bus*>(e)->wake();
+    }
+
+    static auto loop(context& ctx, attached_bus& self) -> task<>;
+
+    bus_t bus;
+
+    std::mutex lock{};
+    completion* waiting = nullptr;
+    /** Process once on start, for anything queued before attaching. */
+    bool ready = true;
+    bool stopped = false;
+
+    // Destroyed first, waiting for a running notification to finish.
+    event_source_t source;
+};
+
+template <execution::receiver R>
+struct attached_bus_operation : attached_bus::completion
+{
+    attached_bus_operation(attached_bus& b, R r) :
+        b(b), receiver(std::move(r))
+    {}
+    attached_bus_operation(attached_bus_operation&&) = delete;
+
+    void start() noexcept
+    {
+        b.wait(this);
+    }
+
+    void complete() noexcept override final
+    {
+        execution::set_value(std::move(this->receiver));
+    }
+
+    attached_bus& b;
+    R receiver;
+};
+
+/* The sender for an attached bus to need processing. */
+struct attached_bus_sender
+{
+    using sender_concept = execution::sender_t;
+
+    explicit attached_bus_sender(attached_bus& b) : b(b) {}
+
+    template <typename Self, class... Env>
+    static constexpr auto get_completion_signatures(Self&&, Env&&...)
+        -> execution::completion_signatures<execution::set_value_t()>;
+
+    template <execution::receiver R>
+    auto connect(R r) -> attached_bus_operation<R>
+    {
+        return {b, std::move(r)};
+    }
+
+    attached_bus& b;
+};
+
+auto attached_bus::loop(context& ctx, attached_bus& self) -> task<>
+{
+    const uint64_t batch = std::max<size_t>(ctx.options.process_batch, 1);
+
+    while (!ctx.final_stop.stop_requested())
+    {
+        // The bus is woken on the sd-event thread, so transfer back to the
+        // worker thread, ahead of the ordinary tasks.
+        co_await execution::continues_on(
+            attached_bus_sender(self), ctx.loop.get_scheduler(priority::high));
+
+        // The tasks resumed by the messages keep their own priority.
+        run_loop::priority_scope scope{priority::normal};
+        uint64_t processed = 0;
+        while ((processed < batch) && self.bus.process_discard())
+        {
+            ++processed;
+        }
+
+        ctx.stat_wakeups.fetch_add(1, std::memory_order_relaxed);
+        ctx.stat_messages.fetch_add(processed, std::memory_order_relaxed);
+        if (processed > ctx.stat_max_batch.load(std::memory_order_relaxed))
+        {
+            ctx.stat_max_batch.store(processed, std::memory_order_relaxed);
+        }
+
+        // A full batch might leave more messages, so go around again once
+        // other tasks have run.
+        if (processed == batch)
+        {
+            self.wake();
+            continue;
+        }
+
+        self.arm_timeout();
+    }
+}
+
 } // namespace details
 
 context::~context() noexcept(false)
@@ -120,6 +337,12 @@ context::~context() noexcept(false)
 
 void context::run()
 {
+    if (options.single_thread)
+    {
+        single_run();
+        return;
+    }
+
     // Run the primary portion of the run-loop.
     caller_run();
 
@@ -127,6 +350,7 @@ void context::run()
 
     // We need to wait for the pending wait process and stop it.
     wait_for_wait_process_stopped();
+    stop_attached_buses();
 
     // Wait for all the internal tasks to complete.
     stdexec::sync_wait(internal_tasks.on_empty());
@@ -161,10 +385,15 @@ static auto watchdog_loop(sdbusplus::async::context& ctx) -> task<>
 
 void context::worker_run()
 {
-    internal_tasks.spawn(watchdog_loop(*this));
+    details::frame_pool::use pool{frames.get()};
+
+    // The watchdog stays at a high priority, so a busy loop of tasks does
+    // not get the process killed.
+    spawn_internal(execution::starts_on(
+        loop.get_scheduler(priority::high), watchdog_loop(*this)));
 
     // Start the sdbus 'wait/process' loop; treat it as an internal task.
-    internal_tasks.spawn(details::wait_process_completion::loop(*this));
+    spawn_internal(details::wait_process_completion::loop(*this));
 
     // Run the execution::run_loop to handle all the tasks.
     loop.run();
@@ -195,12 +424,13 @@ void context::check_stop_requested()
     }
 }
 
-void context::spawn(task<void>&& t)
+void context::spawn(task<void>&& t, priority prio)
 {
     check_stop_requested();
 
-    pending_tasks.spawn(
-        std::move(execution::starts_on(loop.get_scheduler(), std::move(t))));
+    pending_tasks.spawn(counted(
+        live_pending,
+        execution::starts_on(loop.get_scheduler(prio), std::move(t))));
 
     spawn_watcher();
 }
@@ -218,8 +448,8 @@ void context::spawn_watcher()
     }
 
     // Spawn the watch for completion / exceptions.
-    internal_tasks.spawn(pending_tasks.on_empty() |
-                         execution::then([this]() { spawn_complete(); }));
+    spawn_internal(pending_tasks.on_empty() |
+                   execution::then([this]() { spawn_complete(); }));
 }
 
 void context::caller_run()
@@ -286,10 +516,30 @@ void context::wait_for_wait_process_stopped()
 
 void details::wait_process_completion::start() noexcept
 {
-    // Call process.  True indicates something was handled and we do not
-    // need to `wait`, because there might be yet another pending operation
-    // to process, so immediately signal the operation as complete.
-    if (ctx.get_bus().process_discard())
+    // Call process until it indicates there is nothing left to handle, or
+    // until a full batch has been handled.
+    const uint64_t batch = std::max<size_t>(ctx.options.process_batch, 1);
+
+    // The processing is scheduled at a high priority, but the tasks resumed
+    // by the messages should not inherit it.
+    run_loop::priority_scope scope{priority::normal};
+    uint64_t processed = 0;
+    while ((processed < batch) && ctx.get_bus().process_discard())
+    {
+        ++processed;
+    }
+
+    ctx.stat_wakeups.fetch_add(1, std::memory_order_relaxed);
+    ctx.stat_messages.fetch_add(processed, std::memory_order_relaxed);
+    if (processed > ctx.stat_max_batch.load(std::memory_order_relaxed))
+    {
+        ctx.stat_max_batch.store(processed, std::memory_order_relaxed);
+    }
+
+    // A full batch means there might be yet another pending operation to
+    // process, so we do not need to `wait`; signal the operation as complete
+    // so that other tasks get to run before the next batch.
+    if (processed == batch)
     {
         this->complete();
         return;
@@ -313,6 +563,14 @@ void details::wait_process_completion::start() noexcept
         timeout = std::chrono::microseconds(to_usec);
     }
 
+    // With a single thread, the caller is the thread running this, so
+    // there is no hand-off to perform.
+    if (ctx.options.single_thread)
+    {
+        ctx.pending = this;
+        return;
+    }
+
     // Assign ourselves as the pending completion and release the caller.
     std::lock_guard lock{ctx.lock};
     ctx.staged = this;
@@ -348,6 +606,134 @@ void details::wait_process_completion::wait_once(context& ctx)
     }
 }
 
+void context::single_run()
+{
+    single_thread_id = std::this_thread::get_id();
+    details::frame_pool::use pool{frames.get()};
+
+    if (!single_started)
+    {
+        single_started = true;
+        spawn_internal(execution::starts_on(
+            loop.get_scheduler(priority::high), watchdog_loop(*this)));
+        spawn_internal(details::wait_process_completion::loop(*this));
+    }
+    else
+    {
+        // We've already been running and there might a completion pending.
+        // Spawn a new watcher that checks for these.
+        spawn_watcher();
+    }
+
+    // Run the primary portion of the run-loop.
+    single_run_until([this]() { return final_stop.stop_requested(); });
+
+    // Stop the wait/process loop.
+    single_run_until([this]() {
+        if (auto worker = std::exchange(pending, nullptr); worker != nullptr)
+        {
+            worker->stop();
+        }
+        return wait_process_stopped;
+    });
+
+    stop_attached_buses();
+
+    // Wait for all the internal tasks to complete.
+    bool internal_complete = false;
+    pending_tasks.spawn(internal_tasks.on_empty() |
+                        execution::then([&internal_complete]() {
+                            internal_complete = true;
+                        }));
+    single_run_until([&internal_complete]() { return internal_complete; });
+}
+
+template <typename Done>
+void context::single_run_until(Done&& done)
+{
+    using namespace std::literals;
+
+    while (!done())
+    {
+        // Run everything which is ready.
+        loop.run_pending();
+        if (done())
+        {
+            break;
+        }
+
+        // More work was queued while running; poll the sd-events without
+        // blocking so that they are not starved, and go back to the tasks.
+        if (!loop.try_idle())
+        {
+            event_loop.run_one(0us);
+            continue;
+        }
+
+        auto worker = pending;
+        auto timeout = worker ? worker->timeout : event_t::time_resolution{-1};
+        event_loop.run_one(timeout);
+        loop.end_idle();
+
+        // If the wait/process was not completed by a dbus event, the sd-bus
+        // timeout may have expired, which also requires a process.
+        if ((worker != nullptr) && (pending == worker) &&
+            (timeout.count() >= 0))
+        {
+            std::exchange(pending, nullptr)->complete();
+        }
+    }
+}
+
+bus_t& context::attach_bus(bus_t&& b)
+{
+    check_stop_requested();
+
+    auto attached =
+        std::make_unique<details::attached_bus>(*this, std::move(b));
+    auto& result = *attached;
+    {
+        std::lock_guard l{lock};
+        attached_buses.emplace_back(std::move(attached));
+    }
+
+    spawn_internal(execution::starts_on(
+        loop.get_scheduler(), details::attached_bus::loop(*this, result)));
+
+    return result.bus;
+}
+
+void context::stop_attached_buses()
+{
+    std::lock_guard l{lock};
+    for (auto& b : attached_buses)
+    {
+        b->wake(true);
+    }
+}
+
+context_stats context::get_stats() const noexcept
+{
+    auto tasks = loop.get_stats();
+    auto events = event_loop.get_stats();
+
+    context_stats stats{};
+    stats.wakeups = stat_wakeups.load(std::memory_order_relaxed);
+    stats.messages = stat_messages.load(std::memory_order_relaxed);
+    stats.max_messages_per_wakeup =
+        stat_max_batch.load(std::memory_order_relaxed);
+    stats.tasks_run = tasks.tasks;
+    stats.scheduling_lag = tasks.lag;
+    stats.max_scheduling_lag = tasks.max_lag;
+    stats.busy_time = tasks.busy;
+    stats.event_dispatches = events.dispatches;
+    stats.event_dispatch_time = events.dispatch_time;
+    stats.max_event_dispatch_time = events.max_dispatch_time;
+    stats.pending_tasks = live_pending.load(std::memory_order_relaxed);
+    stats.internal_tasks = live_internal.load(std::memory_order_relaxed);
+    return stats;
+}
+
 int context::dbus_event_handle(sd_event_source*, int, uint32_t, void* data)
 {
     auto self = static_cast<context*>(data);
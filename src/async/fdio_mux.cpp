@@ -0,0 +1,405 @@
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <sdbusplus/async/fdio_mux.hpp>
+#include <sdbusplus/exception.hpp>
+
+#include <cerrno>
+
+namespace sdbusplus::async
+{
+
+namespace
+{
+
+/** Retry a system call interrupted by a signal.
+ *
+ *  @return The result, or -1 with errno set; an fd which would block is
+ *          reported as -1 with errno EAGAIN.
+ */
+template <typename F>
+ssize_t retry(F&& f)
+{
+    ssize_t rc = 0;
+    do
+    {
+        rc = f();
+    } while ((rc < 0) && (errno == EINTR));
+
+    if ((rc < 0) && (errno == EWOULDBLOCK))
+    {
+        errno = EAGAIN;
+    }
+    return rc;
+}
+
+/** Check the result of a system call from `retry`.
+ *
+ *  @return false if the fd would block.
+ */
+bool check(ssize_t rc, const char* what)
+{
+    if (rc >= 0)
+    {
+        return true;
+    }
+    if (errno == EAGAIN)
+    {
+        return false;
+    }
+    throw exception::SdBusError(errno, what);
+}
+
+} // namespace
+
+namespace fdio_mux_ns
+{
+
+bool read_some_state::perform(int fd)
+{
+    auto rc = retry([&]() { return ::read(fd, buffer.data(), buffer.size()); });
+    if (!check(rc, "read"))
+    {
+        return false;
+    }
+
+    count = static_cast<size_t>(rc);
+    return true;
+}
+
+bool readv_some_state::perform(int fd)
+{
+    auto rc = retry([&]() {
+        return ::readv(fd, buffers.data(), static_cast<int>(buffers.size()));
+    });
+    if (!check(rc, "readv"))
+    {
+        return false;
+    }
+
+    count = static_cast<size_t>(rc);
+    return true;
+}
+
+bool read_pooled_state::perform(int fd)
+{
+    auto b = pool->get();
+    auto space = b.space();
+
+    auto rc = retry([&]() { return ::read(fd, space.data(), space.size()); });
+
+    // The buffer goes back to the pool while waiting.
+    if (!check(rc, "read"))
+    {
+        return false;
+    }
+
+    b.resize(static_cast<size_t>(rc));
+    buffer = std::move(b);
+    return true;
+}
+
+bool read_exact_state::perform(int fd)
+{
+    while (done < buffer.size())
+    {
+        auto rc = retry([&]() {
+            return ::read(fd, buffer.data() + done, buffer.size() - done);
+        });
+        if (!check(rc, "read"))
+        {
+            return false;
+        }
+        if (rc == 0)
+        {
+            throw fdio_eof_exception();
+        }
+
+        done += static_cast<size_t>(rc);
+    }
+
+    return true;
+}
+
+bool write_all_state::perform(int fd)
+{
+    while (done < buffer.size())
+    {
+        auto rc = retry([&]() {
+            return ::write(fd, buffer.data() + done, buffer.size() - done);
+        });
+        if (!check(rc, "write"))
+        {
+            return false;
+        }
+
+        done += static_cast<size_t>(rc);
+    }
+
+    return true;
+}
+
+bool writev_all_state::perform(int fd)
+{
+    while (index < buffers.size())
+    {
+        ssize_t rc = 0;
+
+        // Finish a partially written iovec on its own, so the caller's
+        // array is used as-is for the rest.
+        if (offset != 0)
+        {
+            const auto& v = buffers[index];
+            rc = retry([&]() {
+                return ::write(fd, static_cast<const std::byte*>(v.iov_base) +
+                                       offset,
+                               v.iov_len - offset);
+            });
+        }
+        else
+        {
+            rc = retry([&]() {
+                return ::writev(fd, buffers.data() + index,
+                                static_cast<int>(buffers.size() - index));
+            });
+        }
+        if (!check(rc, "writev"))
+        {
+            return false;
+        }
+
+        // Skip over the iovecs written in full.
+        auto written = static_cast<size_t>(rc) + offset;
+        offset = 0;
+        while ((index < buffers.size()) && (written >= buffers[index].iov_len))
+        {
+            written -= buffers[index].iov_len;
+            ++index;
+        }
+        offset = written;
+    }
+
+    return true;
+}
+
+} // namespace fdio_mux_ns
+
+fdio_mux::fdio_mux(context& ctx) : context_ref(ctx) {}
+
+fdio_mux::~fdio_mux()
+{
+    while (true)
+    {
+        int fd = -1;
+        {
+            std::lock_guard l{lock};
+            if (watches.empty())
+            {
+                break;
+            }
+            fd = watches.begin()->first;
+        }
+        remove(fd);
+    }
+}
+
+void fdio_mux::add(int fd)
+{
+    auto w = std::make_unique<watch>(this, fd);
+
+    try
+    {
+        w->source = get_event_loop(ctx).add_io(
+            fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, handler, w.get());
+    }
+    catch (...)
+    {
+        throw std::runtime_error("Failed to add fd to event loop");
+    }
+
+    std::lock_guard l{lock};
+    if (!watches.emplace(fd, std::move(w)).second)
+    {
+        throw std::invalid_argument("fd already added to fdio_mux");
+    }
+}
+
+void fdio_mux::remove(int fd)
+{
+    std::unique_ptr<watch> w{};
+    details::intrusive_queue<fdio_mux_ns::io_completion> stopped{};
+
+    {
+        std::lock_guard l{lock};
+
+        auto it = watches.find(fd);
+        if (it == watches.end())
+        {
+            return;
+        }
+        w = std::move(it->second);
+        watches.erase(it);
+
+        for (auto q : {&w->readers, &w->writers})
+        {
+            while (!q->empty())
+            {
+                auto c = q->pop_front();
+                c->queued = false;
+                stopped.push_back(c);
+            }
+        }
+    }
+
+    while (!stopped.empty())
+    {
+        stopped.pop_front()->stop();
+    }
+
+    // Destroying the watch waits for a notification which is running on the
+    // sd-event thread; it no longer has any waiters to resume.
+    w.reset();
+}
+
+void fdio_mux::start_io(fdio_mux_ns::io_completion* c) noexcept
+{
+    std::unique_lock l{lock};
+
+    auto it = watches.find(c->fd);
+    if (it == watches.end())
+    {
+        l.unlock();
+        try
+        {
+            throw exception::SdBusError(EBADF, "fdio_mux: fd not added");
+        }
+        catch (...)
+        {
+            c->error(std::current_exception());
+        }
+        return;
+    }
+
+    auto& w = *it->second;
+    auto& queue = c->write ? w.writers : w.readers;
+    auto& ready = c->write ? w.writable : w.readable;
+
+    // Attempt the I/O right away, unless it must wait behind others (to keep
+    // the order of the data) or the fd is known to block.
+    if (queue.empty() && ready)
+    {
+        try
+        {
+            if (c->perform(c->fd))
+            {
+                l.unlock();
+                c->complete();
+                return;
+            }
+        }
+        catch (...)
+        {
+            l.unlock();
+            c->error(std::current_exception());
+            return;
+        }
+
+        // The lock is held until queued, so a readiness notification racing
+        // with the attempt finds the waiter.
+        ready = false;
+    }
+
+    c->queued = true;
+    queue.push_back(c);
+}
+
+bool fdio_mux::cancel(fdio_mux_ns::io_completion* c) noexcept
+{
+    std::lock_guard l{lock};
+
+    if (!c->queued)
+    {
+        return false;
+    }
+    c->queued = false;
+
+    if (auto it = watches.find(c->fd); it != watches.end())
+    {
+        auto& queue = c->write ? it->second->writers : it->second->readers;
+
+        details::intrusive_queue<fdio_mux_ns::io_completion> removed{};
+        queue.extract_if([c](auto& e) { return &e == c; }, removed);
+    }
+
+    return true;
+}
+
+int fdio_mux::handler(sd_event_source*, int, uint32_t revents,
+                      void* data) noexcept
+{
+    auto w = static_cast<watch*>(data);
+    w->mux->handle_event(*w, revents);
+
+    return 0;
+}
+
+void fdio_mux::handle_event(watch& w, uint32_t revents) noexcept
+{
+    details::intrusive_queue<fdio_mux_ns::io_completion> done{};
+
+    // Resume the waiters in order until the fd would block again.  Errors
+    // and hang-ups are reported by the I/O itself, so they wake both sides.
+    auto resume = [&done](auto& queue, bool& ready) {
+        ready = true;
+        while (ready && !queue.empty())
+        {
+            auto c = queue.front();
+            try
+            {
+                if (!c->perform(c->fd))
+                {
+                    ready = false;
+                    break;
+                }
+            }
+            catch (...)
+            {
+                c->failure = std::current_exception();
+            }
+
+            queue.pop_front();
+            c->queued = false;
+            done.push_back(c);
+        }
+    };
+
+    {
+        std::lock_guard l{lock};
+
+        if (revents & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        {
+            resume(w.readers, w.readable);
+        }
+        if (revents & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+        {
+            resume(w.writers, w.writable);
+        }
+    }
+
+    // Complete outside of the lock, since the completions may start more I/O
+    // or remove the fd.
+    while (!done.empty())
+    {
+        auto c = done.pop_front();
+        if (c->failure)
+        {
+            c->error(std::exchange(c->failure, nullptr));
+        }
+        else
+        {
+            c->complete();
+        }
+    }
+}
+
+} // namespace sdbusplus::async
@@ -0,0 +1,192 @@
+#include <sdbusplus/async/frame_pool.hpp>
+
+#include <new>
+#include <utility>
+
+namespace sdbusplus::async::details
+{
+
+/* The header preceding each frame. */
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) frame_pool::block
+{
+    union
+    {
+        /** The pool of a frame in use; null for a heap frame. */
+        frame_pool* pool;
+        /** The size class of a frame on the remote list. */
+        size_t index;
+    };
+    block* next;
+};
+
+thread_local frame_pool* frame_pool::current = nullptr;
+
+namespace
+{
+
+// Increment a counter which only has a single writer.
+template <typename T>
+void bump(std::atomic<T>& counter) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+}
+
+} // namespace
+
+frame_pool::handle frame_pool::create(size_t retain)
+{
+    return handle{new frame_pool(retain)};
+}
+
+frame_pool::~frame_pool()
+{
+    reclaim();
+
+    for (auto b : free)
+    {
+        while (b != nullptr)
+        {
+            ::operator delete(std::exchange(b, b->next));
+        }
+    }
+}
+
+void frame_pool::release() noexcept
+{
+    unref();
+}
+
+void frame_pool::unref() noexcept
+{
+    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
+void* frame_pool::allocate(size_t size)
+{
+    auto pool = current;
+    auto index = (size - 1) / granularity;
+
+    if ((pool != nullptr) && (index < classes))
+    {
+        return pool->take(index);
+    }
+
+    if (pool != nullptr)
+    {
+        bump(pool->stat_allocations);
+        bump(pool->stat_oversized);
+    }
+
+    auto b = static_cast<block*>(::operator new(sizeof(block) + size));
+    b->pool = nullptr;
+    return b + 1;
+}
+
+void frame_pool::deallocate(void* p, size_t size) noexcept
+{
+    auto b = static_cast<block*>(p) - 1;
+    auto pool = b->pool;
+
+    if (pool == nullptr)
+    {
+        ::operator delete(b);
+        return;
+    }
+
+    b->index = (size - 1) / granularity;
+    if (pool == current)
+    {
+        pool->give(b);
+    }
+    else
+    {
+        // Hand the frame back to the owning thread.
+        b->next = pool->remote.load(std::memory_order_relaxed);
+        while (!pool->remote.compare_exchange_weak(b->next, b,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed))
+        {}
+    }
+
+    pool->unref();
+}
+
+void* frame_pool::take(size_t index)
+{
+    bump(stat_allocations);
+
+    if (free[index] == nullptr)
+    {
+        reclaim();
+    }
+
+    auto b = free[index];
+    if (b != nullptr)
+    {
+        free[index] = b->next;
+        --counts[index];
+        stat_cached.store(stat_cached.load(std::memory_order_relaxed) - 1,
+                          std::memory_order_relaxed);
+        bump(stat_reused);
+    }
+    else
+    {
+        // Allocate the whole size class, so the frame can be reused by any
+        // size within it.
+        b = static_cast<block*>(
+            ::operator new(sizeof(block) + (index + 1) * granularity));
+    }
+
+    b->pool = this;
+    references.fetch_add(1, std::memory_order_relaxed);
+    return b + 1;
+}
+
+void frame_pool::give(block* b) noexcept
+{
+    auto index = b->index;
+
+    if (counts[index] >= retain)
+    {
+        ::operator delete(b);
+        return;
+    }
+
+    b->next = free[index];
+    free[index] = b;
+    ++counts[index];
+    bump(stat_cached);
+}
+
+void frame_pool::reclaim() noexcept
+{
+    auto b = remote.exchange(nullptr, std::memory_order_acquire);
+    while (b != nullptr)
+    {
+        give(std::exchange(b, b->next));
+    }
+}
+
+frame_pool_stats frame_pool::get_stats() const noexcept
+{
+    return {stat_allocations.load(std::memory_order_relaxed),
+            stat_reused.load(std::memory_order_relaxed),
+            stat_oversized.load(std::memory_order_relaxed),
+            references.load(std::memory_order_relaxed) - 1,
+            stat_cached.load(std::memory_order_relaxed)};
+}
+
+frame_pool::use::use(frame_pool* pool) noexcept :
+    previous(std::exchange(current, pool))
+{}
+
+frame_pool::use::~use()
+{
+    current = previous;
+}
+
+} // namespace sdbusplus::async::details
@@ -1,9 +1,11 @@
 #include <sdbusplus/async/match.hpp>
 
+#include <algorithm>
+
 namespace sdbusplus::async
 {
 
-slot_t match::makeMatch(context& ctx, const std::string_view& pattern)
+slot_t match::makeMatch(bus_t& bus, const std::string_view& pattern)
 {
     // C-style callback to redirect into this::handle_match.
     static auto match_cb =
@@ -14,7 +16,7 @@ slot_t match::makeMatch(context& ctx, const std::string_view& pattern)
 
     sd_bus_slot* s;
     auto r =
-        sd_bus_add_match(get_busp(ctx), &s, pattern.data(), match_cb, this);
+        sd_bus_add_match(get_busp(bus), &s, pattern.data(), match_cb, this);
     if (r < 0)
     {
         throw exception::SdBusError(-r, "sd_bus_add_match (async::match)");
@@ -23,8 +25,24 @@ slot_t match::makeMatch(context& ctx, const std::string_view& pattern)
     return slot_t{s, &sdbus_impl};
 }
 
-match::match(context& ctx, const std::string_view& pattern) :
-    slot(makeMatch(ctx, pattern))
+bus::match_mux::subscription match::makeShared(
+    bus_t& bus, const std::string_view& pattern)
+{
+    return bus::match_mux::get(bus)
+        ->add(pattern, [this](message_t& msg) { handle_match(message_t{msg}); });
+}
+
+match::match(context& ctx, const std::string_view& pattern,
+             const match_options& options) :
+    options(options),
+    slot(options.shared
+             ? slot_t{}
+             : makeMatch(options.bus ? *options.bus : ctx.get_bus(), pattern)),
+    subscription(
+        options.shared
+            ? makeShared(options.bus ? *options.bus : ctx.get_bus(), pattern)
+            : bus::match_mux::subscription{}),
+    queue(options.capacity)
 {}
 
 match::~match()
@@ -42,6 +60,15 @@ match::~match()
     }
 }
 
+match_stats match::get_stats()
+{
+    std::lock_guard l{lock};
+
+    auto result = stats;
+    result.queued = queue.size();
+    return result;
+}
+
 void match_ns::match_completion::start() noexcept
 {
     // Set ourselves as the awaiting Receiver and see if there is a message
@@ -68,15 +95,129 @@ void match_ns::match_completion::start() noexcept
     m.handle_completion(std::move(lock));
 }
 
+bool match_ns::match_completion::cancel() noexcept
+{
+    std::lock_guard lock{m.lock};
+
+    if (m.complete != this)
+    {
+        return false;
+    }
+    m.complete = nullptr;
+    return true;
+}
+
+std::string match_key::path(message_t& m)
+{
+    return m.get_path();
+}
+
+std::string match_key::properties_changed(message_t& m)
+{
+    std::string interface{};
+    m.read(interface);
+
+    return std::string(m.get_path()) + " " + interface;
+}
+
 void match::handle_match(message_t&& msg) noexcept
 {
+    // Get the coalescing key, if any, outside of the lock.
+    std::optional<std::string> key{};
+    if (options.coalesce)
+    {
+        try
+        {
+            key = options.coalesce(msg);
+        }
+        catch (...)
+        {
+            // Queue the message without coalescing it.
+        }
+        sd_bus_message_rewind(msg.get(), true);
+    }
+
     // Insert the message into the queue and see if there is a pair ready for
     // completion (Receiver + message).
     std::unique_lock l{lock};
-    queue.emplace(std::move(msg));
+    ++stats.received;
+
+    // Replace the queued message with the same key.  The queue is not empty,
+    // so there is no awaiting Receiver to complete.
+    if (key)
+    {
+        if (auto it = keyed.find(*key); it != keyed.end())
+        {
+            queue[it->second - popped] = std::move(msg);
+            ++stats.coalesced;
+            return;
+        }
+    }
+
+    // The drop_until_drained policy refuses signals until the queue has
+    // been emptied.
+    if (refusing)
+    {
+        ++stats.refused;
+        return;
+    }
+
+    if (queue.full())
+    {
+        switch (options.overflow)
+        {
+            case match_overflow::drop_newest:
+                ++stats.dropped;
+                return;
+
+            case match_overflow::drop_oldest:
+                ++stats.dropped;
+                pop();
+                break;
+
+            case match_overflow::drop_until_drained:
+                ++stats.refused;
+                refusing = true;
+                return;
+        }
+    }
+
+    if (options.coalesce)
+    {
+        if (key)
+        {
+            keyed.emplace(*key, popped + queue.size());
+        }
+        keys.push_back(std::move(key));
+    }
+    queue.push_back(std::move(msg));
+    stats.peak_queued = std::max(stats.peak_queued, queue.size());
+
     handle_completion(std::move(l));
 }
 
+message_t match::pop()
+{
+    if (options.coalesce)
+    {
+        if (auto key = keys.pop_front(); key)
+        {
+            keyed.erase(*key);
+        }
+    }
+    ++popped;
+
+    return queue.pop_front();
+}
+
+void match::check_drained() noexcept
+{
+    if (refusing && queue.empty())
+    {
+        refusing = false;
+    }
+}
+
 void match::handle_completion(std::unique_lock<std::mutex>&& l) noexcept
 {
     auto lock = std::move(l);
@@ -89,17 +230,36 @@ void match::handle_completion(std::unique_lock<std::mutex>&& l) noexcept
         return;
     }
 
-    // Get the waiting completion and message.
+    // Get the waiting completion.
     auto c = std::exchange(complete, nullptr);
-    auto msg = std::move(queue.front());
-    queue.pop();
 
-    // Unlock before calling complete because the completed task may run and
-    // attempt to complete on the next event (and thus deadlock).
+    if (c->max == 0)
+    {
+        // Get the message.
+        auto msg = pop();
+        check_drained();
+
+        // Unlock before calling complete because the completed task may run
+        // and attempt to complete on the next event (and thus deadlock).
+        lock.unlock();
+
+        // Signal completion.
+        c->complete(std::move(msg));
+        return;
+    }
+
+    // Get as many of the messages as requested.
+    std::vector<message_t> msgs{};
+    msgs.reserve(std::min(c->max, queue.size()));
+    while ((msgs.size() < c->max) && !queue.empty())
+    {
+        msgs.emplace_back(pop());
+    }
+    check_drained();
+
     lock.unlock();
 
-    // Signal completion.
-    c->complete(std::move(msg));
+    c->complete_batch(std::move(msgs));
 }
 
 } // namespace sdbusplus::async
@@ -25,12 +25,27 @@ void mutex::unlock()
         return;
     }
     // Wake up the next waiting task
-    auto completion = std::move(waitingTasks.front());
-    waitingTasks.pop();
+    auto completion = waitingTasks.pop_front();
+    completion->queued = false;
     l.unlock();
     completion->complete();
 }
 
+bool mutex::cancel(mutex_ns::mutex_completion* c) noexcept
+{
+    std::lock_guard l{lock};
+
+    if (!c->queued)
+    {
+        return false;
+    }
+    c->queued = false;
+
+    details::intrusive_queue<mutex_ns::mutex_completion> removed{};
+    waitingTasks.extract_if([c](auto& e) { return &e == c; }, removed);
+    return true;
+}
+
 namespace mutex_ns
 {
 
@@ -46,7 +61,8 @@ void mutex_completion::start() noexcept
         return;
     }
 
-    mutexInstance.waitingTasks.push(this);
+    queued = true;
+    mutexInstance.waitingTasks.push_back(this);
 }
 
 } // namespace mutex_ns
@@ -0,0 +1,122 @@
+#include <sdbusplus/async/semaphore.hpp>
+
+namespace sdbusplus::async
+{
+
+semaphore::semaphore(size_t permits, const std::string& name) :
+    name(name), state(permits)
+{}
+
+bool semaphore::try_acquire() noexcept
+{
+    // No permits are available while tasks are waiting.
+    auto s = state.load(std::memory_order_relaxed);
+    while ((s != 0) && ((s & waitingBit) == 0))
+    {
+        if (state.compare_exchange_weak(s, s - 1, std::memory_order_acquire,
+                                        std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void semaphore::release(size_t count) noexcept
+{
+    auto s = state.load(std::memory_order_relaxed);
+    while ((s & waitingBit) == 0)
+    {
+        if (state.compare_exchange_weak(s, s + count, std::memory_order_release,
+                                        std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+
+    // Hand the permits to the waiters.  Only the holder of the queue lock
+    // changes the state while tasks are waiting.
+    details::intrusive_queue<semaphore_ns::semaphore_completion> granted{};
+    {
+        std::lock_guard l{queueLock};
+
+        // The waiters may have been handed permits by another release.
+        if ((state.load(std::memory_order_relaxed) & waitingBit) == 0)
+        {
+            state.fetch_add(count, std::memory_order_release);
+            return;
+        }
+
+        while ((count != 0) && !waitingTasks.empty())
+        {
+            auto c = waitingTasks.pop_front();
+            c->queued = false;
+            granted.push_back(c);
+            --count;
+        }
+
+        state.store(waitingTasks.empty() ? count : waitingBit,
+                    std::memory_order_release);
+    }
+
+    while (!granted.empty())
+    {
+        granted.pop_front()->complete();
+    }
+}
+
+bool semaphore::wait(semaphore_ns::semaphore_completion* c) noexcept
+{
+    std::lock_guard l{queueLock};
+
+    auto s = state.load(std::memory_order_relaxed);
+    while (true)
+    {
+        // A permit may have been released since the fast path was tried.
+        if ((s != 0) && ((s & waitingBit) == 0))
+        {
+            if (state.compare_exchange_weak(s, s - 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+            {
+                return true;
+            }
+            continue;
+        }
+
+        // Flag the waiter, so the next release takes the slow path.
+        if (state.compare_exchange_weak(s, s | waitingBit,
+                                        std::memory_order_relaxed,
+                                        std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    c->queued = true;
+    waitingTasks.push_back(c);
+    return false;
+}
+
+bool semaphore::cancel(semaphore_ns::semaphore_completion* c) noexcept
+{
+    std::lock_guard l{queueLock};
+
+    if (!c->queued)
+    {
+        return false;
+    }
+    c->queued = false;
+
+    details::intrusive_queue<semaphore_ns::semaphore_completion> removed{};
+    waitingTasks.extract_if([c](auto& e) { return &e == c; }, removed);
+
+    // No permits are available while tasks wait, so the count is 0.
+    if (waitingTasks.empty())
+    {
+        state.store(0, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+} // namespace sdbusplus::async
@@ -0,0 +1,240 @@
+#include <sdbusplus/async/shared_mutex.hpp>
+
+namespace sdbusplus::async
+{
+
+shared_mutex::shared_mutex(const std::string& name,
+                           shared_mutex_preference preference) :
+    name(name), preference(preference)
+{}
+
+bool shared_mutex::try_lock() noexcept
+{
+    uint64_t expected = 0;
+    return state.compare_exchange_strong(expected, writerBit,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed);
+}
+
+bool shared_mutex::try_lock_shared() noexcept
+{
+    // With writer preference, a queued writer keeps new readers out.
+    auto blocking = (preference == shared_mutex_preference::writers)
+                        ? (writerBit | waitingBit)
+                        : writerBit;
+
+    auto s = state.load(std::memory_order_relaxed);
+    while ((s & blocking) == 0)
+    {
+        if (state.compare_exchange_weak(s, s + 1, std::memory_order_acquire,
+                                        std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void shared_mutex::unlock() noexcept
+{
+    uint64_t expected = writerBit;
+    if (!state.compare_exchange_strong(expected, 0, std::memory_order_release,
+                                       std::memory_order_relaxed))
+    {
+        release(writerBit);
+    }
+}
+
+void shared_mutex::unlock_shared() noexcept
+{
+    // The last reader out hands the lock to the waiters.
+    auto s = state.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    if (s == waitingBit)
+    {
+        release(0);
+    }
+}
+
+bool shared_mutex::wait(shared_mutex_ns::lock_completion* c) noexcept
+{
+    std::lock_guard l{queueLock};
+
+    auto s = state.load(std::memory_order_relaxed);
+    while (true)
+    {
+        // The lock may have been released since the fast path was tried.
+        // The state cannot be 0 while tasks are waiting, since the lock is
+        // handed to them directly.
+        if (c->shared)
+        {
+            if (((s & writerBit) == 0) &&
+                ((preference == shared_mutex_preference::readers) ||
+                 waitingTasks.empty()))
+            {
+                if (state.compare_exchange_weak(s, s + 1,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed))
+                {
+                    return true;
+                }
+                continue;
+            }
+        }
+        else if (s == 0)
+        {
+            if (state.compare_exchange_weak(s, writerBit,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+            {
+                return true;
+            }
+            continue;
+        }
+
+        // Flag the waiter, so the owner takes the slow path on unlock.
+        if (state.compare_exchange_weak(s, s | waitingBit,
+                                        std::memory_order_relaxed,
+                                        std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    c->queued = true;
+    waitingTasks.push_back(c);
+    ++(c->shared ? waitingReaders : waitingWriters);
+
+    return false;
+}
+
+bool shared_mutex::cancel(shared_mutex_ns::lock_completion* c) noexcept
+{
+    std::lock_guard l{queueLock};
+
+    if (!c->queued)
+    {
+        return false;
+    }
+    c->queued = false;
+
+    details::intrusive_queue<shared_mutex_ns::lock_completion> removed{};
+    waitingTasks.extract_if([c](auto& e) { return &e == c; }, removed);
+    --(c->shared ? waitingReaders : waitingWriters);
+
+    // The lock is still held by someone, whose unlock hands it to any
+    // remaining waiters.
+    if (waitingTasks.empty())
+    {
+        state.fetch_and(~waitingBit, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+void shared_mutex::release(uint64_t held) noexcept
+{
+    details::intrusive_queue<shared_mutex_ns::lock_completion> granted{};
+
+    {
+        std::lock_guard l{queueLock};
+
+        // Once the last reader is gone, a reader may still join before the
+        // lock is handed over (with reader preference); it then hands the
+        // lock over itself.
+        auto expected = held | waitingBit;
+        auto s = state.load(std::memory_order_relaxed);
+        if (s == held)
+        {
+            // The waiters were all cancelled since the unlock tried its fast
+            // path, so there is nobody to hand the lock to; drop it instead.
+            state.compare_exchange_strong(s, 0, std::memory_order_release,
+                                          std::memory_order_relaxed);
+            return;
+        }
+        if (s != expected)
+        {
+            return;
+        }
+
+        enum class grant
+        {
+            readers,
+            writer,
+            leading_readers,
+        } kind;
+        uint64_t next = 0;
+        size_t count = 0;
+
+        if ((preference == shared_mutex_preference::readers) &&
+            (waitingReaders != 0))
+        {
+            kind = grant::readers;
+            count = waitingReaders;
+            next = count;
+        }
+        else if (!waitingTasks.front()->shared)
+        {
+            kind = grant::writer;
+            count = 1;
+            next = writerBit;
+        }
+        else
+        {
+            kind = grant::leading_readers;
+            for (auto c = waitingTasks.front(); (c != nullptr) && c->shared;
+                 c = c->next)
+            {
+                ++count;
+            }
+            next = count;
+        }
+
+        if ((waitingReaders + waitingWriters) > count)
+        {
+            next |= waitingBit;
+        }
+
+        if (!state.compare_exchange_strong(expected, next,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        switch (kind)
+        {
+            case grant::readers:
+                waitingTasks.extract_if([](auto& c) { return c.shared; },
+                                        granted);
+                waitingReaders = 0;
+                break;
+
+            case grant::writer:
+                granted.push_back(waitingTasks.pop_front());
+                --waitingWriters;
+                break;
+
+            case grant::leading_readers:
+                for (size_t i = 0; i < count; ++i)
+                {
+                    granted.push_back(waitingTasks.pop_front());
+                }
+                waitingReaders -= count;
+                break;
+        }
+
+        for (auto c = granted.front(); c != nullptr; c = c->next)
+        {
+            c->queued = false;
+        }
+    }
+
+    // Complete the new owners outside of the lock, since they may unlock
+    // again right away.
+    while (!granted.empty())
+    {
+        granted.pop_front()->complete();
+    }
+}
+
+} // namespace sdbusplus::async
@@ -0,0 +1,270 @@
+#include <time.h>
+
+#include <sdbusplus/async/timer_wheel.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace sdbusplus::async::details
+{
+
+timer_wheel::timer_wheel(event_t& event) :
+    current(static_cast<uint64_t>(now().count()) / tick_usec), event(event),
+    timer(event.add_timer(timer_handler, this)),
+    wake(wake_handler, this)
+{}
+
+auto timer_wheel::now() -> time_point
+{
+    timespec ts{};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+
+    return std::chrono::duration_cast<time_point>(
+        std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+}
+
+void timer_wheel::add(entry& e, time_point when)
+{
+    auto usec = static_cast<uint64_t>(std::max<int64_t>(when.count(), 0));
+    bool signal = false;
+
+    {
+        std::lock_guard l{lock};
+
+        // Round up, so that the timer never fires early.
+        e.expiry = (usec + tick_usec - 1) / tick_usec;
+        insert(e);
+
+        // If the wheel now needs attention before the sd-event timer is due,
+        // have the sd-event thread re-arm it.
+        if ((next_tick() < armed) && !wake_pending)
+        {
+            wake_pending = true;
+            signal = true;
+        }
+    }
+
+    if (signal)
+    {
+        event.submit(wake);
+    }
+}
+
+bool timer_wheel::cancel(entry& e)
+{
+    std::lock_guard l{lock};
+
+    if (!e.linked)
+    {
+        return false;
+    }
+
+    unlink(e);
+    return true;
+}
+
+void timer_wheel::insert(entry& e)
+{
+    auto expiry = std::max(e.expiry, current);
+
+    // Find the lowest level whose slots reach the expiry.
+    unsigned level = 0;
+    while ((level < (levels - 1)) &&
+           (((expiry >> (slot_bits * level)) -
+             (current >> (slot_bits * level))) >= slots))
+    {
+        ++level;
+    }
+
+    // An expiry beyond the span of the top level is parked in its furthest
+    // slot, and placed again when that slot is cascaded.
+    auto index = std::min(expiry >> (slot_bits * level),
+                          (current >> (slot_bits * level)) + slots - 1);
+
+    e.level = level;
+    e.slot = index & (slots - 1);
+    e.linked = true;
+
+    auto& head = wheel[e.level][e.slot];
+    e.prev = nullptr;
+    e.next = head;
+    if (head != nullptr)
+    {
+        head->prev = &e;
+    }
+    head = &e;
+
+    occupied[e.level] |= (uint64_t{1} << e.slot);
+}
+
+void timer_wheel::unlink(entry& e)
+{
+    auto& head = wheel[e.level][e.slot];
+
+    if (e.prev != nullptr)
+    {
+        e.prev->next = e.next;
+    }
+    else
+    {
+        head = e.next;
+    }
+    if (e.next != nullptr)
+    {
+        e.next->prev = e.prev;
+    }
+
+    if (head == nullptr)
+    {
+        occupied[e.level] &= ~(uint64_t{1} << e.slot);
+    }
+
+    e.prev = nullptr;
+    e.next = nullptr;
+    e.linked = false;
+}
+
+uint64_t timer_wheel::next_tick() const
+{
+    uint64_t result = never;
+
+    for (unsigned level = 0; level < levels; ++level)
+    {
+        if (occupied[level] == 0)
+        {
+            continue;
+        }
+
+        // The lowest level holds ticks [current, current + slots); the
+        // higher levels hold the slots after the one containing current.
+        auto shift = slot_bits * level;
+        auto base = (current >> shift) + ((level == 0) ? 0 : 1);
+        auto offset = std::countr_zero(
+            std::rotr(occupied[level], static_cast<int>(base & (slots - 1))));
+
+        result = std::min(result, (base + offset) << shift);
+    }
+
+    return result;
+}
+
+auto timer_wheel::advance(uint64_t target) -> entry*
+{
+    entry* fired = nullptr;
+
+    while (true)
+    {
+        auto next = next_tick();
+        if (next > target)
+        {
+            current = std::max(current, target);
+            break;
+        }
+        current = next;
+
+        // Move the entries of each higher-level slot starting now down to the
+        // lower levels, from the top down so they can cascade repeatedly.
+        for (auto level = levels - 1; level > 0; --level)
+        {
+            auto shift = slot_bits * level;
+            if ((current & ((uint64_t{1} << shift) - 1)) != 0)
+            {
+                continue;
+            }
+
+            auto slot = (current >> shift) & (slots - 1);
+            auto e = std::exchange(wheel[level][slot], nullptr);
+            occupied[level] &= ~(uint64_t{1} << slot);
+
+            while (e != nullptr)
+            {
+                auto n = e->next;
+                insert(*e);
+                e = n;
+            }
+        }
+
+        // Collect the entries expiring now.
+        auto slot = current & (slots - 1);
+        auto e = std::exchange(wheel[0][slot], nullptr);
+        occupied[0] &= ~(uint64_t{1} << slot);
+
+        while (e != nullptr)
+        {
+            auto n = e->next;
+            e->prev = nullptr;
+            e->linked = false;
+            e->next = fired;
+            fired = e;
+            e = n;
+        }
+    }
+
+    return fired;
+}
+
+void timer_wheel::rearm()
+{
+    uint64_t next = never;
+    {
+        std::lock_guard l{lock};
+        next = next_tick();
+        armed = next;
+    }
+
+    if (next == never)
+    {
+        return;
+    }
+
+    try
+    {
+        event.arm_timer_locked(timer, time_point(next * tick_usec));
+    }
+    catch (...)
+    {
+        // Let the next timer added try again.
+        std::lock_guard l{lock};
+        armed = never;
+    }
+}
+
+int timer_wheel::timer_handler(sd_event_source*, uint64_t, void* data) noexcept
+{
+    auto self = static_cast<timer_wheel*>(data);
+
+    entry* fired = nullptr;
+    {
+        std::lock_guard l{self->lock};
+        self->armed = never;
+        fired = self->advance(static_cast<uint64_t>(now().count()) / tick_usec);
+    }
+
+    self->rearm();
+
+    // Fire outside of the lock, since the owners may add new timers.  An
+    // entry may be destroyed by firing it.
+    while (fired != nullptr)
+    {
+        auto n = std::exchange(fired->next, nullptr);
+        fired->fire(fired);
+        fired = n;
+    }
+
+    return 0;
+}
+
+void timer_wheel::wake_handler(void* data) noexcept
+{
+    auto self = static_cast<timer_wheel*>(data);
+
+    {
+        std::lock_guard l{self->lock};
+        self->wake_pending = false;
+    }
+
+    self->rearm();
+}
+
+} // namespace sdbusplus::async::details
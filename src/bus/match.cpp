@@ -41,4 +41,9 @@ match::match(sdbusplus::bus_t& bus, const char* _match, callback_t callback) :
                     _callback.get()))
 {}
 
+match::match(sdbusplus::bus_t& bus, const std::string& _match,
+             callback_t callback, shared_t) :
+    _subscription(bus::match_mux::get(bus)->add(_match, std::move(callback)))
+{}
+
 } // namespace sdbusplus
@@ -0,0 +1,520 @@
+#include <systemd/sd-bus.h>
+
+#include <sdbusplus/bus/match_mux.hpp>
+#include <sdbusplus/exception.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <optional>
+
+namespace sdbusplus::bus
+{
+
+namespace
+{
+
+/** Is `value` equal to, or below, the namespace `ns` (with separator `sep`)?
+ */
+bool in_namespace(std::string_view value, std::string_view ns, char sep)
+{
+    if ((sep == '/') && (ns == "/"))
+    {
+        return true;
+    }
+
+    return value.starts_with(ns) &&
+           ((value.size() == ns.size()) || (value[ns.size()] == sep));
+}
+
+/** Can `key` be checked by match_rule::matches? */
+bool locally_checkable(std::string_view key)
+{
+    return (key == "type") || (key == "interface") || (key == "member") ||
+           (key == "path") || (key == "path_namespace") || (key == "arg0") ||
+           (key == "arg0namespace");
+}
+
+std::string_view type_name(uint8_t type)
+{
+    switch (type)
+    {
+        case SD_BUS_MESSAGE_METHOD_CALL:
+            return "method_call";
+        case SD_BUS_MESSAGE_METHOD_RETURN:
+            return "method_return";
+        case SD_BUS_MESSAGE_METHOD_ERROR:
+            return "error";
+        case SD_BUS_MESSAGE_SIGNAL:
+            return "signal";
+        default:
+            return "";
+    }
+}
+
+bool equals(const char* value, const std::string& expected)
+{
+    return (value != nullptr) && (expected == value);
+}
+
+/** Read the first argument of a message, if it is a string. */
+std::optional<std::string> read_arg0(sd_bus_message* m)
+{
+    std::optional<std::string> arg0{};
+
+    char type = 0;
+    const char* contents = nullptr;
+    const char* value = nullptr;
+    if ((sd_bus_message_peek_type(m, &type, &contents) > 0) &&
+        ((type == 's') || (type == 'o') || (type == 'g')) &&
+        (sd_bus_message_read_basic(m, type, &value) > 0))
+    {
+        arg0.emplace(value);
+    }
+    sd_bus_message_rewind(m, true);
+
+    return arg0;
+}
+
+} // namespace
+
+match_rule match_rule::parse(std::string_view rule)
+{
+    match_rule result{};
+
+    size_t pos = 0;
+    while (pos < rule.size())
+    {
+        auto eq = rule.find('=', pos);
+        if (eq == std::string_view::npos)
+        {
+            throw exception::SdBusError(EINVAL, "match_rule::parse");
+        }
+        std::string key{rule.substr(pos, eq - pos)};
+        pos = eq + 1;
+
+        // Values are quoted with apostrophes; an apostrophe itself is
+        // written, unquoted, as \'.
+        std::string value{};
+        while ((pos < rule.size()) && (rule[pos] != ','))
+        {
+            if (rule[pos] == '\'')
+            {
+                auto end = rule.find('\'', pos + 1);
+                if (end == std::string_view::npos)
+                {
+                    throw exception::SdBusError(EINVAL, "match_rule::parse");
+                }
+                value.append(rule.substr(pos + 1, end - pos - 1));
+                pos = end + 1;
+            }
+            else if ((rule[pos] == '\\') && ((pos + 1) < rule.size()) &&
+                     (rule[pos + 1] == '\''))
+            {
+                value.push_back('\'');
+                pos += 2;
+            }
+            else
+            {
+                value.push_back(rule[pos++]);
+            }
+        }
+
+        result.keys.insert_or_assign(std::move(key), std::move(value));
+
+        // Skip the ','.
+        ++pos;
+    }
+
+    return result;
+}
+
+const std::string* match_rule::find(const std::string& key) const
+{
+    auto it = keys.find(key);
+    return (it == keys.end()) ? nullptr : &it->second;
+}
+
+bool match_rule::subsumes(const match_rule& narrow) const
+{
+    for (const auto& [key, value] : keys)
+    {
+        if (key == "path_namespace")
+        {
+            auto path = narrow.find("path");
+            auto ns = narrow.find("path_namespace");
+            if (!(path && in_namespace(*path, value, '/')) &&
+                !(ns && in_namespace(*ns, value, '/')))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (key == "arg0namespace")
+        {
+            auto arg0 = narrow.find("arg0");
+            auto ns = narrow.find("arg0namespace");
+            if (!(arg0 && in_namespace(*arg0, value, '.')) &&
+                !(ns && in_namespace(*ns, value, '.')))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        auto other = narrow.find(key);
+        if ((other == nullptr) || (*other != value))
+        {
+            return false;
+        }
+    }
+
+    // The keys narrowing the rule must be checked locally.
+    for (const auto& [key, value] : narrow.keys)
+    {
+        auto ours = find(key);
+        if (((ours == nullptr) || (*ours != value)) && !locally_checkable(key))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool match_rule::matches(message_t& m, const std::string* arg0) const
+{
+    for (const auto& [key, value] : keys)
+    {
+        if (key == "type")
+        {
+            if (type_name(m.get_type()) != value)
+            {
+                return false;
+            }
+        }
+        else if (key == "interface")
+        {
+            if (!equals(m.get_interface(), value))
+            {
+                return false;
+            }
+        }
+        else if (key == "member")
+        {
+            if (!equals(m.get_member(), value))
+            {
+                return false;
+            }
+        }
+        else if (key == "path")
+        {
+            if (!equals(m.get_path(), value))
+            {
+                return false;
+            }
+        }
+        else if (key == "path_namespace")
+        {
+            auto path = m.get_path();
+            if ((path == nullptr) || !in_namespace(path, value, '/'))
+            {
+                return false;
+            }
+        }
+        else if (key == "arg0")
+        {
+            if ((arg0 == nullptr) || (*arg0 != value))
+            {
+                return false;
+            }
+        }
+        else if (key == "arg0namespace")
+        {
+            if ((arg0 == nullptr) || !in_namespace(*arg0, value, '.'))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+match_mux::subscription& match_mux::subscription::operator=(subscription&& s)
+{
+    if (&s != this)
+    {
+        reset();
+        mux = std::move(s.mux);
+        sub = std::move(s.sub);
+    }
+    return *this;
+}
+
+match_mux::subscription::~subscription()
+{
+    reset();
+}
+
+void match_mux::subscription::reset()
+{
+    if (sub)
+    {
+        mux->remove(sub);
+    }
+    sub.reset();
+    mux.reset();
+}
+
+match_mux::match_mux(bus_t& b) : bus(get_busp(b), b.getInterface()) {}
+
+std::shared_ptr<match_mux> match_mux::get(bus_t& bus)
+{
+    static std::mutex lock{};
+    static std::map<sd_bus*, std::weak_ptr<match_mux>> muxes{};
+
+    std::lock_guard l{lock};
+    std::erase_if(muxes, [](const auto& e) { return e.second.expired(); });
+
+    // The multiplexer holds a reference to the bus, so the address cannot be
+    // reused by another bus while the entry is alive.
+    auto& entry = muxes[get_busp(bus)];
+    auto mux = entry.lock();
+    if (!mux)
+    {
+        mux = std::make_shared<match_mux>(bus);
+        entry = mux;
+    }
+    return mux;
+}
+
+auto match_mux::add(std::string_view rule, callback_t callback) -> subscription
+{
+    auto s = std::make_shared<subscriber>();
+    s->rule = match_rule::parse(rule);
+    s->callback = std::move(callback);
+
+    std::lock_guard l{lock};
+
+    // Share a registration which covers the rule.
+    for (auto& r : registered)
+    {
+        if (r->rule.subsumes(s->rule))
+        {
+            s->exact = (r->rule.keys == s->rule.keys);
+            r->insert(s);
+            return {shared_from_this(), std::move(s)};
+        }
+    }
+
+    // Otherwise register the rule with the daemon.
+    auto r = std::make_shared<registration>();
+    r->rule_string = std::string(rule);
+    r->rule = s->rule;
+    r->mux = this;
+
+    sd_bus_slot* slot = nullptr;
+    auto rc = bus.getInterface()->sd_bus_add_match(
+        get_busp(bus), &slot, r->rule_string.c_str(), handler, r.get());
+    if (rc < 0)
+    {
+        throw exception::SdBusError(-rc, "sd_bus_add_match (match_mux)");
+    }
+    r->slot = slot_t{slot, bus.getInterface()};
+
+    s->exact = true;
+    r->insert(s);
+
+    // Fold the registrations the new rule subsumes into it.
+    std::erase_if(registered, [&r](auto& other) {
+        if (!r->rule.subsumes(other->rule))
+        {
+            return false;
+        }
+
+        auto move = [&r](auto& sub) {
+            sub->exact = (r->rule.keys == sub->rule.keys);
+            r->insert(sub);
+        };
+        for (auto& index : other->indexes)
+        {
+            for (auto& [value, sub] : index)
+            {
+                move(sub);
+            }
+        }
+        std::ranges::for_each(other->others, move);
+
+        return true;
+    });
+
+    registered.emplace_back(std::move(r));
+    return {shared_from_this(), std::move(s)};
+}
+
+size_t match_mux::registrations()
+{
+    std::lock_guard l{lock};
+    return registered.size();
+}
+
+void match_mux::remove(const std::shared_ptr<subscriber>& s)
+{
+    // Release the registration outside of the lock, since it may be the one
+    // currently dispatching.
+    std::shared_ptr<registration> released{};
+
+    {
+        std::lock_guard l{lock};
+
+        s->active = false;
+        auto owner = std::exchange(s->owner, nullptr);
+        if (owner == nullptr)
+        {
+            return;
+        }
+
+        owner->erase(s.get());
+        if (owner->empty())
+        {
+            auto it = std::ranges::find_if(
+                registered, [owner](auto& r) { return r.get() == owner; });
+            if (it != registered.end())
+            {
+                released = std::move(*it);
+                registered.erase(it);
+            }
+        }
+    }
+}
+
+auto match_mux::registration::index_of(const match_rule& rule)
+    -> std::pair<size_t, const std::string*>
+{
+    for (size_t i = 0; i < index_keys.size(); ++i)
+    {
+        if (auto value = rule.find(index_keys[i]); value != nullptr)
+        {
+            return {i, value};
+        }
+    }
+    return {index_keys.size(), nullptr};
+}
+
+void match_mux::registration::insert(const std::shared_ptr<subscriber>& s)
+{
+    s->owner = this;
+
+    if (auto [index, value] = index_of(s->rule); value != nullptr)
+    {
+        indexes[index].emplace(*value, s);
+    }
+    else
+    {
+        others.emplace_back(s);
+    }
+}
+
+void match_mux::registration::erase(const subscriber* s)
+{
+    if (auto [index, value] = index_of(s->rule); value != nullptr)
+    {
+        auto [first, last] = indexes[index].equal_range(*value);
+        for (auto it = first; it != last; ++it)
+        {
+            if (it->second.get() == s)
+            {
+                indexes[index].erase(it);
+                return;
+            }
+        }
+    }
+    else
+    {
+        std::erase_if(others, [s](auto& o) { return o.get() == s; });
+    }
+}
+
+bool match_mux::registration::empty() const
+{
+    return std::ranges::all_of(indexes, [](auto& i) { return i.empty(); }) &&
+           others.empty();
+}
+
+int match_mux::handler(sd_bus_message* m, void* data, sd_bus_error*) noexcept
+{
+    auto r = static_cast<registration*>(data);
+    r->mux->dispatch(*r, m);
+
+    return 0;
+}
+
+void match_mux::dispatch(registration& r, sd_bus_message* m)
+{
+    message_t msg{m};
+
+    constexpr auto index = [](std::string_view key) -> size_t {
+        return std::ranges::find(registration::index_keys, key) -
+               registration::index_keys.begin();
+    };
+
+    // Gather the candidates under the lock; the callbacks may add or remove
+    // subscriptions.
+    std::vector<std::shared_ptr<subscriber>> candidates{};
+    std::shared_ptr<registration> keep{};
+    std::optional<std::string> arg0{};
+    {
+        std::lock_guard l{lock};
+        keep = r.shared_from_this();
+
+        auto lookup = [&](size_t i, const char* value) {
+            if (value == nullptr)
+            {
+                return;
+            }
+            auto [first, last] = r.indexes[i].equal_range(value);
+            for (auto it = first; it != last; ++it)
+            {
+                candidates.emplace_back(it->second);
+            }
+        };
+
+        lookup(index("path"), msg.get_path());
+        lookup(index("member"), msg.get_member());
+        lookup(index("interface"), msg.get_interface());
+        candidates.insert(candidates.end(), r.others.begin(), r.others.end());
+
+        // The first argument is only read when it is indexed on, or checked.
+        auto need_arg0 =
+            !r.indexes[index("arg0")].empty() ||
+            std::ranges::any_of(candidates, [](auto& s) {
+                return !s->exact && (s->rule.find("arg0") ||
+                                     s->rule.find("arg0namespace"));
+            });
+        if (need_arg0)
+        {
+            arg0 = read_arg0(m);
+            lookup(index("arg0"), arg0 ? arg0->c_str() : nullptr);
+        }
+    }
+
+    for (auto& s : candidates)
+    {
+        if (!s->active)
+        {
+            continue;
+        }
+        if (!s->exact && !s->rule.matches(msg, arg0 ? &*arg0 : nullptr))
+        {
+            continue;
+        }
+
+        s->callback(msg);
+
+        // Each subscriber gets the message from the start.
+        sd_bus_message_rewind(m, true);
+    }
+}
+
+} // namespace sdbusplus::bus
@@ -4,6 +4,8 @@
 #include <sdbusplus/event.hpp>
 #include <sdbusplus/exception.hpp>
 
+#include <cassert>
+
 namespace sdbusplus::event
 {
 
@@ -91,11 +93,48 @@ event::event()
     run_condition = add_condition(run_wakeup, this);
 }
 
+event::event(sd_event* e) : eventp(sd_event_ref(e))
+{
+    if (eventp == nullptr)
+    {
+        throw exception::SdBusError(EINVAL, __func__);
+    }
+    run_condition = add_condition(run_wakeup, this);
+}
+
 void event::run_one(time_resolution timeout)
 {
     auto l = obtain_lock<false>();
 
-    auto rc = sd_event_run(eventp, static_cast<uint64_t>(timeout.count()));
+    apply_submissions();
+
+    // The steps of sd_event_run, so that the dispatch can be timed apart
+    // from the wait.
+    auto rc = sd_event_prepare(eventp);
+    if (rc == 0)
+    {
+        rc = sd_event_wait(eventp, static_cast<uint64_t>(timeout.count()));
+    }
+    if (rc > 0)
+    {
+        auto start = std::chrono::steady_clock::now();
+        rc = sd_event_dispatch(eventp);
+        auto elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+
+        stat_dispatches.store(
+            stat_dispatches.load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+        stat_dispatch_time.store(
+            stat_dispatch_time.load(std::memory_order_relaxed) + elapsed,
+            std::memory_order_relaxed);
+        if (elapsed > stat_max_dispatch_time.load(std::memory_order_relaxed))
+        {
+            stat_max_dispatch_time.store(elapsed, std::memory_order_relaxed);
+        }
+    }
     if (rc < 0)
     {
         throw exception::SdBusError(-rc, __func__);
@@ -107,6 +146,56 @@ void event::break_run()
     run_condition.signal();
 }
 
+void event::submit(submission& s)
+{
+    auto head = submissions.load(std::memory_order_relaxed);
+    do
+    {
+        s.next = head;
+    } while (!submissions.compare_exchange_weak(
+        head, &s, std::memory_order_release, std::memory_order_relaxed));
+
+    // Nothing is running the loop (or this thread is), so apply it now.
+    if (std::unique_lock l{lock, std::try_to_lock}; l.owns_lock())
+    {
+        held_lock held{*this, std::move(l)};
+        apply_submissions();
+        return;
+    }
+
+    // Otherwise wake 'run_one', unless an earlier submission already has.
+    if (head == nullptr)
+    {
+        run_condition.signal();
+    }
+}
+
+void event::apply_submissions()
+{
+    auto s = submissions.exchange(nullptr, std::memory_order_acquire);
+
+    // Reverse the list so submissions are applied in order.
+    submission* ordered = nullptr;
+    while (s != nullptr)
+    {
+        auto next = s->next;
+        s->next = ordered;
+        ordered = s;
+        s = next;
+    }
+
+    // A handler submitting again may apply the queue from within this one.
+    auto outer = std::exchange(applying, true);
+    while (ordered != nullptr)
+    {
+        // The submission may be queued again by its handler.
+        auto next = std::exchange(ordered->next, nullptr);
+        ordered->handler(ordered->data);
+        ordered = next;
+    }
+    applying = outer;
+}
+
 source event::add_io(int fd, uint32_t events, sd_event_io_handler_t handler,
                      void* data)
 {
@@ -165,17 +254,70 @@ source event::add_oneshot_timer(sd_event_time_handler_t handler, void* data,
     return s;
 }
 
+source event::add_timer(sd_event_time_handler_t handler, void* data,
+                        time_resolution accuracy)
+{
+    auto l = obtain_lock();
+
+    source s{*this};
+
+    auto rc = sd_event_add_time(eventp, &s.sourcep, CLOCK_BOOTTIME, UINT64_MAX,
+                                accuracy.count(), handler, data);
+
+    if (rc < 0)
+    {
+        throw exception::SdBusError(-rc, __func__);
+    }
+
+    return s;
+}
+
+void event::arm_timer(source& s, time_resolution time)
+{
+    auto l = obtain_lock();
+    arm_timer_locked(s, time);
+}
+
+void event::arm_timer_locked(source& s, time_resolution time)
+{
+    assert(holds_lock());
+
+    auto rc = sd_event_source_set_time(s.sourcep,
+                                       static_cast<uint64_t>(time.count()));
+    if (rc >= 0)
+    {
+        rc = sd_event_source_set_enabled(s.sourcep, SD_EVENT_ONESHOT);
+    }
+
+    if (rc < 0)
+    {
+        throw exception::SdBusError(-rc, __func__);
+    }
+}
+
 int event::run_wakeup(sd_event_source*, int, uint32_t, void* data)
 {
     auto self = static_cast<event*>(data);
     self->run_condition.ack();
+    self->apply_submissions();
 
     return 0;
 }
 
 template <bool Signal>
-std::unique_lock<std::recursive_mutex> event::obtain_lock()
+auto event::obtain_lock() -> held_lock
 {
+    // Taking the stage while holding the lock would invert the lock order
+    // with a thread waiting in obtain_lock, and the lock cannot block this
+    // thread anyway.
+    if (holds_lock())
+    {
+        // Submission handlers must only use the primitives for a caller
+        // holding the lock (see `submission`).
+        assert(!applying);
+        return {*this, std::unique_lock{this->lock}};
+    }
+
     std::unique_lock stage{this->obtain_lock_stage};
 
     std::unique_lock<std::recursive_mutex> l{this->lock, std::defer_lock_t()};
@@ -192,7 +334,7 @@ std::unique_lock<std::recursive_mutex> event::obtain_lock()
         l.lock();
     }
 
-    return l;
+    return {*this, std::move(l)};
 }
 
 } // namespace sdbusplus::event
@@ -1,5 +1,9 @@
 #include <sdbusplus/server/interface.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <string_view>
+
 namespace sdbusplus
 {
 
@@ -40,6 +44,10 @@ interface::interface(sdbusplus::bus_t& bus, const sdbusplus::object_path& path,
 
 interface::~interface()
 {
+    if (_signal_source != nullptr)
+    {
+        sd_event_source_unref(_signal_source);
+    }
     emit_removed();
 }
 
@@ -53,6 +61,114 @@ void interface::property_changed(const char* property)
         get_busp(_bus), _path.c_str(), _interf.c_str(), values.data());
 }
 
+void interface::set_signal_policy(const char* property,
+                                  const signal_policy& policy)
+{
+    _signal_throttles.insert_or_assign(property, signal_throttle{policy});
+}
+
+void interface::flush_signals()
+{
+    _signal_deadline.reset();
+
+    auto now = signal_throttle::clock::now();
+    for (auto& [name, throttle] : _signal_throttles)
+    {
+        if (throttle.expired(now))
+        {
+            property_changed(name.c_str());
+        }
+    }
+
+    arm_signal_timer();
+}
+
+void interface::property_changed_throttled(const char* property,
+                                           std::optional<double> value)
+{
+    auto throttle = _signal_throttles.find(std::string_view{property});
+    if (throttle == _signal_throttles.end())
+    {
+        property_changed(property);
+        return;
+    }
+
+    if (throttle->second.changed(value, signal_throttle::clock::now()))
+    {
+        property_changed(property);
+    }
+    else
+    {
+        arm_signal_timer();
+    }
+}
+
+void interface::arm_signal_timer()
+{
+    std::optional<signal_throttle::clock::time_point> next{};
+    for (const auto& [name, throttle] : _signal_throttles)
+    {
+        auto due = throttle.deadline();
+        if (due && (!next || (*due < *next)))
+        {
+            next = due;
+        }
+    }
+
+    // Nothing deferred, or the timer is already set to fire early enough.
+    if (!next || (_signal_deadline && (*_signal_deadline <= *next)))
+    {
+        return;
+    }
+    _signal_deadline = next;
+
+    auto delay = std::max(std::chrono::ceil<std::chrono::microseconds>(
+                              *next - signal_throttle::clock::now()),
+                          std::chrono::microseconds{0});
+
+    if (_signal_timer)
+    {
+        if (!_signal_self)
+        {
+            _signal_self = std::make_shared<interface*>(this);
+        }
+        _signal_timer(delay, signal_flush{_signal_self});
+        return;
+    }
+
+    auto event = _bus.get_event();
+    if (event == nullptr)
+    {
+        _signal_deadline.reset();
+        return;
+    }
+
+    if (_signal_source == nullptr)
+    {
+        if (sd_event_add_time_relative(event, &_signal_source, CLOCK_MONOTONIC,
+                                       delay.count(), 0, signal_timer_handler,
+                                       this) < 0)
+        {
+            _signal_source = nullptr;
+            _signal_deadline.reset();
+        }
+        return;
+    }
+
+    if ((sd_event_source_set_time_relative(_signal_source, delay.count()) <
+         0) ||
+        (sd_event_source_set_enabled(_signal_source, SD_EVENT_ONESHOT) < 0))
+    {
+        _signal_deadline.reset();
+    }
+}
+
+int interface::signal_timer_handler(sd_event_source*, uint64_t, void* data)
+{
+    static_cast<interface*>(data)->flush_signals();
+    return 0;
+}
+
 } // namespace interface
 } // namespace server
 } // namespace sdbusplus
@@ -0,0 +1,157 @@
+#include <sdbusplus/async.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class ChannelTest : public ::testing::Test
+{
+  protected:
+    ~ChannelTest() noexcept override = default;
+
+    void run()
+    {
+        ctx.spawn(
+            sdbusplus::async::sleep_for(ctx, 500ms) |
+            sdbusplus::async::execution::then([&]() { ctx.request_stop(); }));
+        ctx.run();
+    }
+
+    sdbusplus::async::context ctx;
+};
+
+TEST_F(ChannelTest, SendReceive)
+{
+    sdbusplus::async::channel<std::unique_ptr<int>> ch{};
+    std::vector<int> received{};
+
+    auto consumer = [&]() -> sdbusplus::async::task<> {
+        for (auto i = 0; i < 3; ++i)
+        {
+            received.push_back(*(co_await ch.receive()));
+        }
+    };
+    auto producer = [&]() -> sdbusplus::async::task<> {
+        for (auto i = 0; i < 3; ++i)
+        {
+            co_await ch.send(std::make_unique<int>(i));
+        }
+    };
+
+    ctx.spawn(consumer());
+    ctx.spawn(producer());
+
+    run();
+
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), received);
+}
+
+TEST_F(ChannelTest, SendWaitsWhenFull)
+{
+    sdbusplus::async::channel<int> ch{2};
+    int sent = 0;
+
+    auto producer = [&]() -> sdbusplus::async::task<> {
+        for (auto i = 0; i < 5; ++i)
+        {
+            co_await ch.send(i);
+            ++sent;
+        }
+    };
+    auto consumer = [&]() -> sdbusplus::async::task<> {
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+
+        // The producer is held at the capacity of the channel.
+        EXPECT_EQ(2, sent);
+        EXPECT_EQ(2u, ch.size());
+        EXPECT_FALSE(ch.try_send(10));
+
+        // Each value received lets one more send complete.
+        EXPECT_EQ(0, ch.try_receive());
+        EXPECT_EQ(3, sent);
+
+        auto values = co_await ch.receive_batch(10);
+        EXPECT_EQ((std::vector<int>{1, 2}), values);
+        EXPECT_EQ(5, sent);
+        EXPECT_EQ(2u, ch.size());
+    };
+
+    ctx.spawn(producer());
+    ctx.spawn(consumer());
+
+    run();
+
+    EXPECT_EQ(5, sent);
+}
+
+TEST_F(ChannelTest, MultipleProducersAndConsumers)
+{
+    static constexpr int producers = 4;
+    static constexpr int count = 100;
+
+    sdbusplus::async::channel<int> ch{8};
+    int total = 0;
+    int received = 0;
+
+    auto producer = [&]() -> sdbusplus::async::task<> {
+        for (auto i = 1; i <= count; ++i)
+        {
+            co_await ch.send(i);
+        }
+    };
+    auto consumer = [&]() -> sdbusplus::async::task<> {
+        while (received < (producers * count))
+        {
+            auto values = co_await ch.receive_batch(3);
+            for (auto v : values)
+            {
+                total += v;
+            }
+            received += values.size();
+        }
+        ch.close();
+    };
+
+    for (auto p = 0; p < producers; ++p)
+    {
+        ctx.spawn(producer());
+        ctx.spawn(consumer());
+    }
+
+    run();
+
+    EXPECT_EQ(producers * count, received);
+    EXPECT_EQ(producers * count * (count + 1) / 2, total);
+}
+
+TEST_F(ChannelTest, CloseStopsWaiters)
+{
+    sdbusplus::async::channel<std::string> ch{1};
+    bool receiverStopped = false;
+    bool senderStopped = false;
+
+    ctx.spawn(ch.receive() | sdbusplus::async::execution::then(
+                                 [](std::string) { FAIL(); }) |
+              sdbusplus::async::execution::upon_stopped(
+                  [&]() { receiverStopped = true; }));
+
+    auto closer = [&]() -> sdbusplus::async::task<> {
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        ch.close();
+
+        EXPECT_FALSE(ch.try_send("dropped"));
+        co_await (ch.send("dropped") |
+                  sdbusplus::async::execution::upon_stopped(
+                      [&]() { senderStopped = true; }));
+    };
+    ctx.spawn(closer());
+
+    run();
+
+    EXPECT_TRUE(receiverStopped);
+    EXPECT_TRUE(senderStopped);
+}
@@ -0,0 +1,145 @@
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class ConcurrentTest : public ::testing::Test
+{
+  protected:
+    ~ConcurrentTest() noexcept override = default;
+
+    static auto visit(sdbusplus::async::context& ctx, int item, int& inFlight,
+                      int& peak, std::vector<int>& done)
+        -> sdbusplus::async::task<>
+    {
+        peak = std::max(peak, ++inFlight);
+        co_await sdbusplus::async::sleep_for(ctx, 1ms * (item % 3));
+        --inFlight;
+        done.push_back(item);
+    }
+
+    static auto visitAll(sdbusplus::async::context& ctx,
+                         const std::vector<int>& items, int& inFlight,
+                         int& peak, std::vector<int>& done)
+        -> sdbusplus::async::task<>
+    {
+        co_await sdbusplus::async::for_each_concurrent(
+            ctx, items, 4, [&](int item) {
+                return visit(ctx, item, inFlight, peak, done);
+            });
+        ctx.request_stop();
+    }
+
+    static auto square(sdbusplus::async::context& ctx, int item)
+        -> sdbusplus::async::task<int>
+    {
+        // Later items complete first.
+        co_await sdbusplus::async::sleep_for(ctx, 1ms * (10 - item));
+        co_return item * item;
+    }
+
+    static auto squareAll(sdbusplus::async::context& ctx,
+                          std::vector<int>& results) -> sdbusplus::async::task<>
+    {
+        std::vector<int> items(10);
+        std::iota(items.begin(), items.end(), 0);
+
+        results = co_await sdbusplus::async::when_all_bounded(
+            ctx, std::move(items), 3,
+            [&ctx](int item) { return square(ctx, item); });
+        ctx.request_stop();
+    }
+
+    static auto failOrWait(sdbusplus::async::context& ctx, int item,
+                           int& started) -> sdbusplus::async::task<>
+    {
+        ++started;
+        if (item == 1)
+        {
+            co_await sdbusplus::async::sleep_for(ctx, 1ms);
+            throw std::runtime_error("failed");
+        }
+        co_await sdbusplus::async::sleep_for(ctx, 1h);
+    }
+
+    static auto failFast(sdbusplus::async::context& ctx, int& started,
+                         bool& failed) -> sdbusplus::async::task<>
+    {
+        std::vector<int> items(100);
+        std::iota(items.begin(), items.end(), 0);
+
+        try
+        {
+            co_await sdbusplus::async::for_each_concurrent(
+                ctx, items, 5, [&](int item) {
+                    return failOrWait(ctx, item, started);
+                });
+        }
+        catch (const std::runtime_error&)
+        {
+            failed = true;
+        }
+        ctx.request_stop();
+    }
+
+    sdbusplus::async::context ctx;
+};
+
+TEST_F(ConcurrentTest, BoundsInFlight)
+{
+    std::vector<int> items(20);
+    std::iota(items.begin(), items.end(), 0);
+
+    int inFlight = 0;
+    int peak = 0;
+    std::vector<int> done{};
+
+    ctx.spawn(visitAll(ctx, items, inFlight, peak, done));
+    ctx.run();
+
+    EXPECT_EQ(4, peak);
+    EXPECT_EQ(0, inFlight);
+
+    std::ranges::sort(done);
+    EXPECT_EQ(items, done);
+}
+
+TEST_F(ConcurrentTest, ResultsInOrder)
+{
+    std::vector<int> results{};
+
+    ctx.spawn(squareAll(ctx, results));
+    ctx.run();
+
+    std::vector<int> expected(10);
+    for (auto i = 0; i < 10; ++i)
+    {
+        expected[i] = i * i;
+    }
+    EXPECT_EQ(expected, results);
+}
+
+TEST_F(ConcurrentTest, FailureStopsInFlight)
+{
+    int started = 0;
+    bool failed = false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    ctx.spawn(failFast(ctx, started, failed));
+    ctx.run();
+
+    auto stop = std::chrono::steady_clock::now();
+
+    // The sleeping operations were stopped, and no more were started.
+    EXPECT_TRUE(failed);
+    EXPECT_EQ(5, started);
+    EXPECT_LT(stop - start, 10s);
+}
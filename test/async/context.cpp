@@ -2,6 +2,10 @@
 
 #include <sdbusplus/async.hpp>
 
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 struct Context : public testing::Test
@@ -147,3 +151,333 @@ TEST_F(Context, DestructMatcherWithPendingAwaitAsTask)
     runToStop();
     EXPECT_FALSE(ran);
 }
+
+TEST_F(Context, ProcessesMessagesInBatches)
+{
+    static constexpr size_t count = 100;
+    static constexpr size_t batch = 8;
+    static constexpr auto path = "/xyz/openbmc_project/sdbusplus/test/batch";
+
+    ctx = std::make_unique<sdbusplus::async::context>(
+        sdbusplus::bus::new_bus(),
+        sdbusplus::async::context_options{.process_batch = batch});
+
+    sdbusplus::async::match m(
+        *ctx, sdbusplus::bus::match::rules::type::signal() +
+                  sdbusplus::bus::match::rules::path(path));
+
+    // Queue up all of the signals before the context starts processing.
+    auto sender = sdbusplus::bus::new_bus();
+    for (size_t i = 0; i < count; ++i)
+    {
+        sender.new_signal(path, "xyz.openbmc_project.sdbusplus.test.Batch",
+                          "Signal")
+            .signal_send();
+    }
+    sender.flush();
+
+    struct _
+    {
+        static auto receive(sdbusplus::async::context& ctx,
+                            sdbusplus::async::match& m)
+            -> sdbusplus::async::task<>
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                co_await m.next();
+            }
+            ctx.request_stop();
+        }
+    };
+
+    ctx->spawn(_::receive(*ctx, m));
+    ctx->run();
+
+    auto stats = ctx->get_stats();
+    EXPECT_GE(stats.messages, count);
+    EXPECT_GT(stats.max_messages_per_wakeup, 1u);
+    EXPECT_LE(stats.max_messages_per_wakeup, batch);
+    EXPECT_LT(stats.wakeups, stats.messages);
+}
+
+TEST_F(Context, ReportsLoad)
+{
+    using namespace std::literals;
+
+    struct _
+    {
+        static auto sample(sdbusplus::async::context& ctx,
+                           sdbusplus::async::context_stats& during)
+            -> sdbusplus::async::task<>
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                co_await sdbusplus::async::sleep_for(ctx, 1ms);
+            }
+            during = ctx.get_stats();
+            ctx.request_stop();
+        }
+    };
+
+    sdbusplus::async::context_stats during{};
+    ctx->spawn(_::sample(*ctx, during));
+    ctx->run();
+
+    // The sampling task, and the dbus processing, were running.
+    EXPECT_EQ(1u, during.pending_tasks);
+    EXPECT_LE(1u, during.internal_tasks);
+
+    auto stats = ctx->get_stats();
+    EXPECT_LE(4u, stats.tasks_run);
+    EXPECT_LE(stats.max_scheduling_lag, stats.scheduling_lag);
+    EXPECT_LT(0ns, stats.busy_time);
+    EXPECT_LE(3u, stats.event_dispatches);
+    EXPECT_LE(stats.max_event_dispatch_time, stats.event_dispatch_time);
+    EXPECT_EQ(0u, stats.pending_tasks);
+    EXPECT_EQ(0u, stats.internal_tasks);
+}
+
+TEST_F(Context, PoolsTaskFrames)
+{
+    static constexpr size_t count = 1000;
+
+    struct _
+    {
+        static auto one() -> sdbusplus::async::pooled_task<int>
+        {
+            co_return 1;
+        }
+
+        static auto many(sdbusplus::async::context& ctx)
+            -> sdbusplus::async::pooled_task<>
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                total += co_await one();
+            }
+            EXPECT_EQ(count, total);
+            ctx.request_stop();
+        }
+    };
+
+    // Spawn from the worker thread, so the outer frame is pooled too.
+    ctx->spawn(stdexec::just() | stdexec::then([this]() {
+                   ctx->spawn(_::many(*ctx));
+               }));
+    ctx->run();
+
+    // Once warm, each nested task reuses the frame of the previous one.
+    auto stats = ctx->get_frame_stats();
+    EXPECT_GT(stats.allocations, count);
+    EXPECT_GE(stats.reused, count - 1);
+    EXPECT_EQ(0u, stats.oversized);
+    EXPECT_EQ(0u, stats.in_use);
+}
+
+TEST_F(Context, FramePoolDisabled)
+{
+    ctx = std::make_unique<sdbusplus::async::context>(
+        sdbusplus::bus::new_bus(),
+        sdbusplus::async::context_options{.frame_pool_retain = 0});
+    runToStop();
+
+    EXPECT_EQ(0u, ctx->get_frame_stats().allocations);
+}
+
+TEST_F(Context, SharesExternalEvent)
+{
+    sd_event* e = nullptr;
+    ASSERT_LE(0, sd_event_default(&e));
+
+    ctx = std::make_unique<sdbusplus::async::context>(
+        sdbusplus::bus::new_bus(),
+        sdbusplus::async::context_options{.event = e});
+    EXPECT_EQ(e, ctx->get_event());
+
+    struct _
+    {
+        static int fired(sd_event_source*, uint64_t, void* data)
+        {
+            static_cast<Context*>(data)->spawnStop();
+            return 0;
+        }
+    };
+
+    // A source added by other code, directly on the shared sd_event, is
+    // dispatched by the context.
+    sd_event_source* source = nullptr;
+    ASSERT_LE(0, sd_event_add_time_relative(e, &source, CLOCK_MONOTONIC, 1000,
+                                            0, _::fired, this));
+    ctx->run();
+
+    sd_event_source_unref(source);
+    sd_event_unref(e);
+}
+
+TEST_F(Context, RunsHigherPriorityFirst)
+{
+    using sdbusplus::async::priority;
+
+    std::vector<int> order{};
+    auto record = [&order](int i) {
+        return stdexec::just() |
+               stdexec::then([&order, i]() { order.push_back(i); });
+    };
+
+    // Nothing runs until the context does, so all of these are queued.
+    ctx->spawn(record(0), priority::low);
+    ctx->spawn(record(1), priority::normal);
+    ctx->spawn(record(2), priority::high);
+    ctx->spawn(record(3), priority::normal);
+    ctx->spawn(stdexec::just() |
+                   stdexec::then([this]() { ctx->request_stop(); }),
+               priority::low);
+    ctx->run();
+
+    EXPECT_EQ(std::vector<int>({2, 1, 3, 0}), order);
+}
+
+TEST_F(Context, LowPriorityIsNotStarved)
+{
+    using sdbusplus::async::priority;
+    static constexpr size_t limit = 4;
+
+    ctx = std::make_unique<sdbusplus::async::context>(
+        sdbusplus::bus::new_bus(),
+        sdbusplus::async::context_options{.starvation_limit = limit});
+
+    struct _
+    {
+        // Keep the high priority queue busy until the low task has run.
+        static auto spin(sdbusplus::async::context& ctx, bool& lowRan,
+                         size_t& spins) -> sdbusplus::async::task<>
+        {
+            while (!lowRan)
+            {
+                ++spins;
+                co_await stdexec::schedule(ctx.get_scheduler(priority::high));
+            }
+            ctx.request_stop();
+        }
+    };
+
+    bool lowRan = false;
+    size_t spins = 0;
+    ctx->spawn(stdexec::just() | stdexec::then([&lowRan]() { lowRan = true; }),
+               priority::low);
+    ctx->spawn(_::spin(*ctx, lowRan, spins), priority::high);
+    ctx->run();
+
+    EXPECT_TRUE(lowRan);
+    EXPECT_LE(spins, 2 * limit);
+}
+
+TEST_F(Context, AttachedBus)
+{
+    static constexpr auto path = "/xyz/openbmc_project/sdbusplus/test/attach";
+
+    auto& bus = ctx->attach_bus(sdbusplus::bus::new_bus());
+    EXPECT_NE(ctx->get_bus().get_unique_name(), bus.get_unique_name());
+
+    // Signals sent from the primary bus are received on the attached one.
+    sdbusplus::async::match m(*ctx,
+                              sdbusplus::bus::match::rules::type::signal() +
+                                  sdbusplus::bus::match::rules::path(path),
+                              sdbusplus::async::match_options{.bus = &bus});
+
+    struct _
+    {
+        static auto run(sdbusplus::async::context& ctx, sdbusplus::bus_t& bus,
+                        sdbusplus::async::match& m, std::string& id)
+            -> sdbusplus::async::task<>
+        {
+            id = co_await sdbusplus::async::proxy()
+                     .service("org.freedesktop.DBus")
+                     .path("/org/freedesktop/DBus")
+                     .interface("org.freedesktop.DBus")
+                     .on_bus(bus)
+                     .call<std::string>(ctx, "GetId");
+
+            ctx.get_bus()
+                .new_signal(path, "xyz.openbmc_project.sdbusplus.test.Attach",
+                            "Signal")
+                .signal_send();
+            co_await m.next();
+
+            ctx.request_stop();
+        }
+    };
+
+    std::string id{};
+    ctx->spawn(_::run(*ctx, bus, m, id));
+    ctx->run();
+
+    EXPECT_FALSE(id.empty());
+}
+
+struct SingleThreadContext : public Context
+{
+    SingleThreadContext()
+    {
+        ctx = std::make_unique<sdbusplus::async::context>(
+            sdbusplus::bus::new_bus(),
+            sdbusplus::async::context_options{.single_thread = true});
+    }
+};
+
+TEST_F(SingleThreadContext, RunSimple)
+{
+    runToStop();
+}
+
+TEST_F(SingleThreadContext, ReentrantRun)
+{
+    runToStop();
+    for (int i = 0; i < 100; ++i)
+    {
+        ctx->run();
+    }
+}
+
+TEST_F(SingleThreadContext, SpawnedTasksRunOnCaller)
+{
+    using namespace std::literals;
+
+    auto caller = std::this_thread::get_id();
+    std::thread::id ran{};
+
+    ctx->spawn(sdbusplus::async::sleep_for(*ctx, 1ms) |
+               stdexec::then([&ran]() { ran = std::this_thread::get_id(); }));
+
+    runToStop();
+
+    EXPECT_EQ(caller, ran);
+}
+
+TEST_F(SingleThreadContext, SpawnFromOtherThread)
+{
+    using namespace std::literals;
+
+    auto caller = std::this_thread::get_id();
+    std::thread::id ran{};
+
+    // Keep the context busy while the other thread spawns.
+    ctx->spawn(sdbusplus::async::sleep_for(*ctx, 100ms));
+
+    std::thread other{[&]() {
+        std::this_thread::sleep_for(10ms);
+        ctx->spawn(stdexec::just() | stdexec::then([&]() {
+                       ran = std::this_thread::get_id();
+                       ctx->request_stop();
+                   }));
+    }};
+
+    auto start = std::chrono::steady_clock::now();
+    ctx->run();
+    auto stop = std::chrono::steady_clock::now();
+    other.join();
+
+    EXPECT_EQ(caller, ran);
+    EXPECT_LT(stop - start, 1s);
+}
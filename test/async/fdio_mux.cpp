@@ -0,0 +1,170 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class FdioMuxTest : public ::testing::Test
+{
+  protected:
+    ~FdioMuxTest() noexcept override
+    {
+        mux.reset();
+        for (auto fd : fds)
+        {
+            close(fd);
+        }
+    }
+
+    auto makeSocketPair() -> std::array<int, 2>
+    {
+        std::array<int, 2> sv{};
+        EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0,
+                                sv.data()));
+        fds.insert(fds.end(), sv.begin(), sv.end());
+
+        mux->add(sv[0]);
+        mux->add(sv[1]);
+        return sv;
+    }
+
+    void run()
+    {
+        ctx.spawn(
+            sdbusplus::async::sleep_for(ctx, 1s) |
+            sdbusplus::async::execution::then([&]() { ctx.request_stop(); }));
+        ctx.run();
+    }
+
+    sdbusplus::async::context ctx;
+    std::unique_ptr<sdbusplus::async::fdio_mux> mux =
+        std::make_unique<sdbusplus::async::fdio_mux>(ctx);
+    std::vector<int> fds{};
+};
+
+TEST_F(FdioMuxTest, WriteAllReadExact)
+{
+    auto [a, b] = makeSocketPair();
+
+    // Larger than the socket buffers, so both sides have to wait.
+    std::vector<std::byte> sent(4 * 1024 * 1024);
+    std::ranges::generate(sent, [i = 0]() mutable {
+        return static_cast<std::byte>(i++ * 7);
+    });
+    std::vector<std::byte> received(sent.size());
+    bool done = false;
+
+    ctx.spawn(mux->async_write_all(a, sent));
+    ctx.spawn(mux->async_read_exact(b, received) |
+              sdbusplus::async::execution::then([&]() {
+                  done = true;
+                  ctx.request_stop();
+              }));
+    run();
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(sent, received);
+}
+
+TEST_F(FdioMuxTest, ScatterGather)
+{
+    auto [a, b] = makeSocketPair();
+
+    std::array<char, 5> hello{'h', 'e', 'l', 'l', 'o'};
+    std::array<char, 6> world{' ', 'w', 'o', 'r', 'l', 'd'};
+    std::array<iovec, 2> out{iovec{hello.data(), hello.size()},
+                             iovec{world.data(), world.size()}};
+
+    std::array<char, 3> first{};
+    std::array<char, 8> second{};
+    std::array<iovec, 2> in{iovec{first.data(), first.size()},
+                            iovec{second.data(), second.size()}};
+    size_t count = 0;
+
+    auto transfer = [&]() -> sdbusplus::async::task<> {
+        co_await mux->async_write_all(a, out);
+        count = co_await mux->async_read_some(b, in);
+        ctx.request_stop();
+    };
+    ctx.spawn(transfer());
+    run();
+
+    EXPECT_EQ(11u, count);
+    EXPECT_EQ("hel", std::string(first.begin(), first.end()));
+    EXPECT_EQ("lo world", std::string(second.begin(), second.end()));
+}
+
+TEST_F(FdioMuxTest, PooledReadsAcrossFds)
+{
+    static constexpr auto pairs = 3;
+    sdbusplus::async::buffer_pool pool{64, 2};
+    std::vector<std::string> received(pairs);
+
+    auto reader = [&](int fd, int i) -> sdbusplus::async::task<> {
+        // Nothing is available yet, so the read waits without holding a
+        // buffer.
+        auto buffer = co_await mux->async_read_some(fd, pool);
+        auto data = buffer.data();
+        received[i] =
+            std::string(reinterpret_cast<char*>(data.data()), data.size());
+    };
+    auto writer = [&](int fd, int i) -> sdbusplus::async::task<> {
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        auto message = "fd " + std::to_string(i);
+        co_await mux->async_write_all(
+            fd, std::as_bytes(std::span(message.data(), message.size())));
+    };
+
+    for (auto i = 0; i < pairs; ++i)
+    {
+        auto [a, b] = makeSocketPair();
+
+        ctx.spawn(reader(b, i));
+        ctx.spawn(writer(a, i));
+    }
+    run();
+
+    for (auto i = 0; i < pairs; ++i)
+    {
+        EXPECT_EQ("fd " + std::to_string(i), received[i]);
+    }
+}
+
+TEST_F(FdioMuxTest, EndOfFile)
+{
+    auto [a, b] = makeSocketPair();
+    bool eof = false;
+    size_t count = 1;
+
+    auto readToEnd = [&]() -> sdbusplus::async::task<> {
+        std::array<std::byte, 8> buffer{};
+
+        mux->remove(a);
+        close(a);
+        fds.erase(std::ranges::find(fds, a));
+
+        count = co_await mux->async_read_some(b, buffer);
+        try
+        {
+            co_await mux->async_read_exact(b, buffer);
+        }
+        catch (const sdbusplus::async::fdio_eof_exception&)
+        {
+            eof = true;
+        }
+        ctx.request_stop();
+    };
+    ctx.spawn(readToEnd());
+    run();
+
+    EXPECT_EQ(0u, count);
+    EXPECT_TRUE(eof);
+}
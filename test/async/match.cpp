@@ -0,0 +1,212 @@
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class MatchTest : public ::testing::Test
+{
+  protected:
+    static constexpr auto path = "/xyz/openbmc_project/sdbusplus/test/match";
+    static constexpr auto interface = "xyz.openbmc_project.sdbusplus.test.Match";
+
+    MatchTest() : ctx(std::make_unique<sdbusplus::async::context>()) {}
+    ~MatchTest() noexcept override = default;
+
+    void TearDown() override
+    {
+        // Destructing the context can throw, so we have to do it in
+        // the TearDown in order to make our destructor noexcept.
+        m.reset();
+        ctx.reset();
+    }
+
+    void makeMatch(const sdbusplus::async::match_options& options)
+    {
+        m = std::make_unique<sdbusplus::async::match>(
+            *ctx,
+            sdbusplus::bus::match::rules::type::signal() +
+                sdbusplus::bus::match::rules::path(path),
+            options);
+    }
+
+    // Queue up signals, carrying their index, before the context starts
+    // processing.
+    void sendSignals(int count)
+    {
+        for (auto i = 0; i < count; ++i)
+        {
+            auto msg = sender.new_signal(path, interface, "Signal");
+            msg.append(i);
+            msg.signal_send();
+        }
+        sender.flush();
+    }
+
+    // Wait for the signals to queue up on the match, then receive them in
+    // batches until `count` have been received.
+    std::vector<std::vector<int>> receive(size_t count)
+    {
+        std::vector<std::vector<int>> batches{};
+
+        ctx->spawn([](sdbusplus::async::context& ctx,
+                      sdbusplus::async::match& m, size_t count,
+                      std::vector<std::vector<int>>& batches)
+                       -> sdbusplus::async::task<> {
+            co_await sdbusplus::async::sleep_for(ctx, 100ms);
+
+            size_t received = 0;
+            while (received < count)
+            {
+                auto msgs = co_await m.next_batch(64);
+
+                auto& batch = batches.emplace_back();
+                for (auto& msg : msgs)
+                {
+                    batch.push_back(msg.unpack<int>());
+                }
+                received += batch.size();
+            }
+
+            ctx.request_stop();
+        }(*ctx, *m, count, batches));
+
+        ctx->run();
+
+        return batches;
+    }
+
+    // Make a call to the dbus-daemon, once the signals have been queued.
+    static auto callDaemon(sdbusplus::async::context& ctx, bool& replied)
+        -> sdbusplus::async::task<>
+    {
+        co_await sdbusplus::async::sleep_for(ctx, 100ms);
+
+        auto id = co_await sdbusplus::async::proxy()
+                      .service("org.freedesktop.DBus")
+                      .path("/org/freedesktop/DBus")
+                      .interface("org.freedesktop.DBus")
+                      .call<std::string>(ctx, "GetId");
+        replied = !id.empty();
+
+        ctx.request_stop();
+    }
+
+    std::unique_ptr<sdbusplus::async::context> ctx;
+    std::unique_ptr<sdbusplus::async::match> m;
+    sdbusplus::bus_t sender = sdbusplus::bus::new_bus();
+};
+
+TEST_F(MatchTest, BatchReceivesBacklog)
+{
+    makeMatch({});
+    sendSignals(10);
+
+    auto batches = receive(10);
+
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), batches[0]);
+
+    auto stats = m->get_stats();
+    EXPECT_EQ(10u, stats.received);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_EQ(10u, stats.peak_queued);
+}
+
+TEST_F(MatchTest, DropOldest)
+{
+    makeMatch({.capacity = 4,
+               .overflow = sdbusplus::async::match_overflow::drop_oldest});
+    sendSignals(10);
+
+    auto batches = receive(4);
+
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ((std::vector<int>{6, 7, 8, 9}), batches[0]);
+
+    auto stats = m->get_stats();
+    EXPECT_EQ(10u, stats.received);
+    EXPECT_EQ(6u, stats.dropped);
+    EXPECT_EQ(4u, stats.peak_queued);
+}
+
+TEST_F(MatchTest, DropNewest)
+{
+    makeMatch({.capacity = 4,
+               .overflow = sdbusplus::async::match_overflow::drop_newest});
+    sendSignals(10);
+
+    auto batches = receive(4);
+
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), batches[0]);
+
+    auto stats = m->get_stats();
+    EXPECT_EQ(10u, stats.received);
+    EXPECT_EQ(6u, stats.dropped);
+}
+
+TEST_F(MatchTest, DropUntilDrainedRefusesUntilEmptied)
+{
+    makeMatch(
+        {.capacity = 4,
+         .overflow = sdbusplus::async::match_overflow::drop_until_drained});
+    sendSignals(10);
+
+    auto batches = receive(4);
+
+    // The queue fills, and the rest are refused until it has been emptied.
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), batches[0]);
+
+    auto stats = m->get_stats();
+    EXPECT_EQ(10u, stats.received);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_EQ(6u, stats.refused);
+    EXPECT_EQ(4u, stats.peak_queued);
+}
+
+TEST_F(MatchTest, DropUntilDrainedDoesNotStopProcessing)
+{
+    makeMatch(
+        {.capacity = 4,
+         .overflow = sdbusplus::async::match_overflow::drop_until_drained});
+    sendSignals(10);
+
+    // Nobody consumes the match, which stays full, yet the replies to
+    // proxy calls are still processed.
+    bool replied = false;
+    ctx->spawn(callDaemon(*ctx, replied));
+    ctx->run();
+
+    EXPECT_TRUE(replied);
+
+    auto stats = m->get_stats();
+    EXPECT_EQ(4u, stats.queued);
+    EXPECT_EQ(6u, stats.refused);
+}
+
+TEST_F(MatchTest, CoalesceKeepsLatestPerKey)
+{
+    makeMatch({.coalesce = [](sdbusplus::message_t& msg) {
+        return std::to_string(msg.unpack<int>() % 3);
+    }});
+    sendSignals(10);
+
+    auto batches = receive(3);
+
+    // Each key keeps the queue position of its first signal, with the value
+    // of its last.
+    ASSERT_EQ(1u, batches.size());
+    EXPECT_EQ((std::vector<int>{9, 7, 8}), batches[0]);
+
+    auto stats = m->get_stats();
+    EXPECT_EQ(10u, stats.received);
+    EXPECT_EQ(7u, stats.coalesced);
+    EXPECT_EQ(3u, stats.peak_queued);
+}
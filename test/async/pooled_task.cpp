@@ -0,0 +1,107 @@
+#include <sdbusplus/async/execution.hpp>
+#include <sdbusplus/async/pooled_task.hpp>
+#include <sdbusplus/async/task.hpp>
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+using namespace sdbusplus::async;
+
+TEST(PooledTask, CoAwaitVoid)
+{
+    bool value = false;
+    auto t = [&]() -> pooled_task<> {
+        value = true;
+        co_return;
+    };
+
+    // Check to ensure the co-routine hasn't started executing yet.
+    EXPECT_FALSE(value);
+
+    // Run it and confirm the value is updated.
+    stdexec::sync_wait(t());
+    EXPECT_TRUE(value);
+}
+
+TEST(PooledTask, CoAwaitValue)
+{
+    struct _
+    {
+        static auto one() -> pooled_task<int>
+        {
+            co_return 42;
+        }
+        static auto two() -> pooled_task<int>
+        {
+            co_return (co_await one()) + 1;
+        }
+    };
+
+    auto [v] = stdexec::sync_wait(_::two()).value();
+    EXPECT_EQ(43, v);
+}
+
+TEST(PooledTask, Exception)
+{
+    struct _
+    {
+        static auto one() -> pooled_task<int>
+        {
+            throw std::logic_error("Failed");
+            co_return 1;
+        }
+        static auto two() -> pooled_task<int>
+        {
+            co_return co_await one();
+        }
+    };
+
+    EXPECT_THROW(stdexec::sync_wait(_::two()), std::logic_error);
+}
+
+TEST(PooledTask, MixesWithTask)
+{
+    struct _
+    {
+        static auto one() -> task<int>
+        {
+            co_return 1;
+        }
+        static auto two() -> pooled_task<int>
+        {
+            co_return (co_await one()) + 1;
+        }
+        static auto three() -> task<int>
+        {
+            co_return (co_await two()) + 1;
+        }
+    };
+
+    auto [v] = stdexec::sync_wait(_::three()).value();
+    EXPECT_EQ(3, v);
+}
+
+TEST(PooledTask, StoppedPropagates)
+{
+    struct _
+    {
+        static auto one(bool& resumed) -> pooled_task<int>
+        {
+            co_await stdexec::just_stopped();
+            resumed = true;
+            co_return 1;
+        }
+        static auto two(bool& resumed) -> pooled_task<int>
+        {
+            auto r = co_await one(resumed);
+            resumed = true;
+            co_return r;
+        }
+    };
+
+    // Neither task resumes, and the outer task completes as stopped.
+    bool resumed = false;
+    EXPECT_FALSE(stdexec::sync_wait(_::two(resumed)));
+    EXPECT_FALSE(resumed);
+}
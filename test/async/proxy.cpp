@@ -0,0 +1,75 @@
+#include <exec/when_any.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class ProxyTest : public ::testing::Test
+{
+  protected:
+    ~ProxyTest() noexcept override = default;
+
+    sdbusplus::async::context ctx;
+
+    // A connection which never processes its messages, so calls to it are
+    // never answered.
+    sdbusplus::bus_t silent = sdbusplus::bus::new_bus();
+    std::string silentName = silent.get_unique_name();
+
+    auto silentProxy()
+    {
+        return sdbusplus::async::proxy()
+            .service(silentName)
+            .path("/xyz/openbmc_project/sdbusplus/test/silent")
+            .interface("xyz.openbmc_project.sdbusplus.test.Silent");
+    }
+};
+
+TEST_F(ProxyTest, CallTimesOut)
+{
+    struct _
+    {
+        static auto call(sdbusplus::async::context& ctx, auto proxy,
+                         int& error) -> sdbusplus::async::task<>
+        {
+            try
+            {
+                co_await proxy.timeout(50ms).template call<>(ctx, "Method");
+            }
+            catch (const sdbusplus::exception::SdBusError& e)
+            {
+                error = e.get_errno();
+            }
+            ctx.request_stop();
+        }
+    };
+
+    int error = 0;
+    auto start = std::chrono::steady_clock::now();
+    ctx.spawn(_::call(ctx, silentProxy(), error));
+    ctx.run();
+    auto stop = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(ETIMEDOUT, error);
+    EXPECT_LT(stop - start, 5s);
+}
+
+TEST_F(ProxyTest, StopCancelsCall)
+{
+    bool called = false;
+    auto start = std::chrono::steady_clock::now();
+
+    // The sleep completes first, which requests stop on the call.
+    ctx.spawn(exec::when_any(silentProxy().call<>(ctx, "Method") |
+                                 stdexec::then([&called]() { called = true; }),
+                             sdbusplus::async::sleep_for(ctx, 10ms)) |
+              stdexec::then([this]() { ctx.request_stop(); }));
+    ctx.run();
+    auto stop = std::chrono::steady_clock::now();
+
+    EXPECT_FALSE(called);
+    EXPECT_LT(stop - start, 5s);
+}
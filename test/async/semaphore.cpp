@@ -0,0 +1,92 @@
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class SemaphoreTest : public ::testing::Test
+{
+  protected:
+    ~SemaphoreTest() noexcept override = default;
+
+    auto limited(sdbusplus::async::semaphore& s) -> sdbusplus::async::task<>
+    {
+        sdbusplus::async::semaphore_guard sg{s};
+        co_await sg.acquire();
+
+        peak = std::max(peak, ++concurrent);
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        --concurrent;
+        ++finished;
+    }
+
+    void run()
+    {
+        ctx.spawn(
+            sdbusplus::async::sleep_for(ctx, 500ms) |
+            sdbusplus::async::execution::then([&]() { ctx.request_stop(); }));
+        ctx.run();
+    }
+
+    sdbusplus::async::context ctx;
+    int concurrent = 0;
+    int peak = 0;
+    int finished = 0;
+};
+
+TEST_F(SemaphoreTest, LimitsConcurrency)
+{
+    sdbusplus::async::semaphore s{3};
+
+    for (auto i = 0; i < 10; ++i)
+    {
+        ctx.spawn(limited(s));
+    }
+    run();
+
+    EXPECT_EQ(3, peak);
+    EXPECT_EQ(10, finished);
+
+    // Every permit was returned.
+    EXPECT_TRUE(s.try_acquire());
+    EXPECT_TRUE(s.try_acquire());
+    EXPECT_TRUE(s.try_acquire());
+    EXPECT_FALSE(s.try_acquire());
+}
+
+TEST_F(SemaphoreTest, ReleaseWakesWaiters)
+{
+    sdbusplus::async::semaphore s{0};
+    int acquired = 0;
+
+    auto acquire = [&]() -> sdbusplus::async::task<> {
+        co_await s.acquire();
+        ++acquired;
+    };
+
+    auto release = [&]() -> sdbusplus::async::task<> {
+        EXPECT_FALSE(s.try_acquire());
+
+        for (auto i = 0; i < 3; ++i)
+        {
+            ctx.spawn(acquire());
+        }
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        EXPECT_EQ(0, acquired);
+
+        // Permits go to the waiters first, then become available.
+        s.release(2);
+        EXPECT_EQ(2, acquired);
+        s.release(2);
+        EXPECT_EQ(3, acquired);
+        EXPECT_TRUE(s.try_acquire());
+        EXPECT_FALSE(s.try_acquire());
+    };
+    ctx.spawn(release());
+    run();
+
+    EXPECT_EQ(3, acquired);
+}
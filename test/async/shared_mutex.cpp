@@ -0,0 +1,192 @@
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class SharedMutexTest : public ::testing::Test
+{
+  protected:
+    ~SharedMutexTest() noexcept override = default;
+
+    auto reader(sdbusplus::async::shared_mutex& m, int& concurrent, int& peak)
+        -> sdbusplus::async::task<>
+    {
+        sdbusplus::async::shared_lock_guard lg{m};
+        co_await lg.lock();
+
+        peak = std::max(peak, ++concurrent);
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        --concurrent;
+    }
+
+    auto writer(sdbusplus::async::shared_mutex& m, int& concurrent,
+                bool& overlapped) -> sdbusplus::async::task<>
+    {
+        sdbusplus::async::unique_lock_guard lg{m};
+        co_await lg.lock();
+
+        overlapped |= (concurrent != 0);
+        ++concurrent;
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+        --concurrent;
+    }
+
+    static auto write(sdbusplus::async::shared_mutex& m, bool& written)
+        -> sdbusplus::async::task<>
+    {
+        co_await m.lock();
+        written = true;
+        m.unlock();
+    }
+
+    static auto timedLocks(sdbusplus::async::context& ctx,
+                           sdbusplus::async::shared_mutex& m,
+                           std::atomic<bool>& done) -> sdbusplus::async::task<>
+    {
+        for (auto i = 0; i < 500; ++i)
+        {
+            try
+            {
+                co_await sdbusplus::async::with_timeout(ctx, m.lock(), 1ms);
+                m.unlock();
+            }
+            catch (const sdbusplus::async::timeout_exception&)
+            {}
+        }
+        done = true;
+        ctx.request_stop();
+    }
+
+    void run()
+    {
+        ctx.spawn(
+            sdbusplus::async::sleep_for(ctx, 500ms) |
+            sdbusplus::async::execution::then([&]() { ctx.request_stop(); }));
+        ctx.run();
+    }
+
+    sdbusplus::async::context ctx;
+};
+
+TEST_F(SharedMutexTest, ReadersShare)
+{
+    sdbusplus::async::shared_mutex m{};
+    int concurrent = 0;
+    int peak = 0;
+
+    for (auto i = 0; i < 5; ++i)
+    {
+        ctx.spawn(reader(m, concurrent, peak));
+    }
+    run();
+
+    EXPECT_EQ(5, peak);
+    EXPECT_EQ(0, concurrent);
+}
+
+TEST_F(SharedMutexTest, WritersExclude)
+{
+    sdbusplus::async::shared_mutex m{};
+    int concurrent = 0;
+    int peak = 0;
+    bool overlapped = false;
+
+    for (auto i = 0; i < 5; ++i)
+    {
+        ctx.spawn(writer(m, concurrent, overlapped));
+        ctx.spawn(reader(m, concurrent, peak));
+    }
+    run();
+
+    EXPECT_FALSE(overlapped);
+    EXPECT_EQ(0, concurrent);
+    EXPECT_TRUE(m.try_lock());
+}
+
+TEST_F(SharedMutexTest, WriterPreference)
+{
+    sdbusplus::async::shared_mutex m{};
+    bool written = false;
+
+    auto holdShared = [&]() -> sdbusplus::async::task<> {
+        EXPECT_TRUE(m.try_lock_shared());
+        EXPECT_FALSE(m.try_lock());
+
+        // Queue a writer behind the reader; new readers must now wait.
+        ctx.spawn(write(m, written));
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+
+        EXPECT_FALSE(written);
+        EXPECT_FALSE(m.try_lock_shared());
+
+        // The writer is handed the lock by the last reader out.
+        m.unlock_shared();
+        EXPECT_TRUE(written);
+
+        EXPECT_TRUE(m.try_lock_shared());
+        m.unlock_shared();
+    };
+    ctx.spawn(holdShared());
+    run();
+
+    EXPECT_TRUE(written);
+}
+
+TEST_F(SharedMutexTest, ReaderPreference)
+{
+    sdbusplus::async::shared_mutex m{
+        "test", sdbusplus::async::shared_mutex_preference::readers};
+    bool written = false;
+
+    auto holdShared = [&]() -> sdbusplus::async::task<> {
+        EXPECT_TRUE(m.try_lock_shared());
+
+        ctx.spawn(write(m, written));
+        co_await sdbusplus::async::sleep_for(ctx, 10ms);
+
+        // Readers still share the lock while the writer waits.
+        EXPECT_TRUE(m.try_lock_shared());
+        m.unlock_shared();
+        EXPECT_FALSE(written);
+
+        m.unlock_shared();
+        EXPECT_TRUE(written);
+    };
+    ctx.spawn(holdShared());
+    run();
+
+    EXPECT_TRUE(written);
+}
+
+TEST_F(SharedMutexTest, CancelledWaiterDuringUnlock)
+{
+    sdbusplus::async::shared_mutex m{};
+    std::atomic<bool> done = false;
+
+    // Hold the lock for about as long as the waiters wait, so that waiters
+    // are often cancelled while the holder is handing the lock over.
+    std::thread holder([&]() {
+        for (auto i = 0; !done; ++i)
+        {
+            if (m.try_lock())
+            {
+                std::this_thread::sleep_for(900us + 1us * (i % 200));
+                m.unlock();
+            }
+        }
+    });
+
+    ctx.spawn(timedLocks(ctx, m, done));
+    ctx.run();
+    done = true;
+    holder.join();
+
+    // The lock is not left held once the waiters have gone.
+    EXPECT_TRUE(m.try_lock());
+}
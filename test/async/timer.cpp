@@ -1,8 +1,13 @@
 #include "../valgrind.hpp"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <exec/when_any.hpp>
 #include <sdbusplus/async.hpp>
 
 #include <chrono>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -27,3 +32,266 @@ TEST(Timer, DelaySome)
     EXPECT_GT(stop - start, timeout);
     EXPECT_LT(stop - start, timeout * tolerance);
 }
+
+TEST(Timer, ManySleepers)
+{
+    static constexpr size_t count = 1000;
+    static constexpr auto timeout = 100ms;
+
+    sdbusplus::async::context ctx;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t done = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Spread the timers over the slots of the first two wheel levels.
+        auto delay = timeout + std::chrono::milliseconds(i % 200);
+        ctx.spawn(sdbusplus::async::sleep_for(ctx, delay) |
+                  stdexec::then([&]() {
+                      if (++done == count)
+                      {
+                          ctx.request_stop();
+                      }
+                  }));
+    }
+    ctx.run();
+
+    auto stop = std::chrono::steady_clock::now();
+
+    const auto tolerance = isValgrind() ? 16 : 3;
+
+    EXPECT_EQ(done, count);
+    EXPECT_GT(stop - start, timeout + 199ms);
+    EXPECT_LT(stop - start, (timeout + 199ms) * tolerance);
+}
+
+TEST(Timer, StopCancelsSleep)
+{
+    sdbusplus::async::context ctx;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // The short sleep completes first and stops the long one, which must
+    // then complete promptly for when_any to finish.
+    ctx.spawn(exec::when_any(sdbusplus::async::sleep_for(ctx, 1h),
+                             sdbusplus::async::sleep_for(ctx, 10ms)) |
+              stdexec::then([&ctx]() { ctx.request_stop(); }));
+    ctx.run();
+
+    auto stop = std::chrono::steady_clock::now();
+
+    EXPECT_LT(stop - start, 10s);
+}
+
+TEST(Timer, SleepWhileSourcesChurn)
+{
+    sdbusplus::async::context ctx;
+
+    struct _
+    {
+        static auto sleeper(sdbusplus::async::context& ctx, bool& done)
+            -> sdbusplus::async::task<>
+        {
+            for (auto i = 0; i < 200; ++i)
+            {
+                co_await sdbusplus::async::sleep_for(ctx, 1ms);
+            }
+            done = true;
+        }
+
+        // Add and remove sd-event sources while the timers re-arm from the
+        // sd-event thread.
+        static auto churn(sdbusplus::async::context& ctx, int fd, bool& done)
+            -> sdbusplus::async::task<>
+        {
+            while (!done)
+            {
+                {
+                    sdbusplus::async::fdio f{ctx, fd};
+                }
+                co_await stdexec::schedule(ctx.get_scheduler());
+            }
+            ctx.request_stop();
+        }
+    };
+
+    auto fd = eventfd(0, EFD_NONBLOCK);
+    ASSERT_NE(-1, fd);
+
+    bool done = false;
+    ctx.spawn(_::sleeper(ctx, done));
+    ctx.spawn(_::churn(ctx, fd, done));
+    ctx.run();
+
+    close(fd);
+    EXPECT_TRUE(done);
+}
+
+TEST(Timer, PeriodicDoesNotDrift)
+{
+    static constexpr auto interval = 20ms;
+    static constexpr auto ticks = 25;
+
+    sdbusplus::async::context ctx;
+
+    auto start = std::chrono::steady_clock::now();
+
+    ctx.spawn([](sdbusplus::async::context& ctx) -> sdbusplus::async::task<> {
+        auto timer = sdbusplus::async::periodic(ctx, interval);
+        for (auto i = 0; i < ticks; ++i)
+        {
+            co_await timer.next();
+
+            // Simulate some work per tick, which a loop of sleep_for would
+            // accumulate.
+            std::this_thread::sleep_for(5ms);
+        }
+        ctx.request_stop();
+    }(ctx));
+    ctx.run();
+
+    auto stop = std::chrono::steady_clock::now();
+
+    // A loop of sleep_for would take at least ticks * (interval + 5ms).
+    EXPECT_GT(stop - start, interval * ticks);
+    if (!isValgrind())
+    {
+        EXPECT_LT(stop - start, (interval + 4ms) * ticks);
+    }
+}
+
+TEST(Timer, PeriodicSkipsMissedTicks)
+{
+    sdbusplus::async::context ctx;
+
+    ctx.spawn([](sdbusplus::async::context& ctx) -> sdbusplus::async::task<> {
+        auto timer = sdbusplus::async::periodic(ctx, 10ms);
+
+        co_await timer.next();
+        std::this_thread::sleep_for(55ms);
+
+        // The late tick completes immediately and the missed ones are dropped.
+        auto start = std::chrono::steady_clock::now();
+        co_await timer.next();
+        EXPECT_LT(std::chrono::steady_clock::now() - start, 10ms);
+        EXPECT_GE(timer.skipped(), 4u);
+
+        ctx.request_stop();
+    }(ctx));
+    ctx.run();
+}
+
+TEST(Timer, WithTimeoutExpires)
+{
+    sdbusplus::async::context ctx;
+
+    auto start = std::chrono::steady_clock::now();
+    bool timedOut = false;
+
+    ctx.spawn([](sdbusplus::async::context& ctx,
+                 bool& timedOut) -> sdbusplus::async::task<> {
+        try
+        {
+            co_await sdbusplus::async::with_timeout(
+                ctx, sdbusplus::async::sleep_for(ctx, 1h), 10ms);
+        }
+        catch (const sdbusplus::async::timeout_exception&)
+        {
+            timedOut = true;
+        }
+        ctx.request_stop();
+    }(ctx, timedOut));
+    ctx.run();
+
+    auto stop = std::chrono::steady_clock::now();
+
+    EXPECT_TRUE(timedOut);
+    EXPECT_LT(stop - start, 10s);
+}
+
+TEST(Timer, WithTimeoutPassesValue)
+{
+    sdbusplus::async::context ctx;
+
+    int value = 0;
+
+    ctx.spawn([](sdbusplus::async::context& ctx,
+                 int& value) -> sdbusplus::async::task<> {
+        value = co_await sdbusplus::async::with_timeout(
+            ctx, sdbusplus::async::sleep_for(ctx, 1ms) |
+                     stdexec::then([]() { return 42; }),
+            1h);
+        ctx.request_stop();
+    }(ctx, value));
+    ctx.run();
+
+    EXPECT_EQ(value, 42);
+}
+
+TEST(Timer, WithTimeoutStopsLockWait)
+{
+    sdbusplus::async::context ctx;
+    sdbusplus::async::mutex mutex{"WithTimeout"};
+
+    bool timedOut = false;
+    bool relocked = false;
+
+    ctx.spawn([](sdbusplus::async::context& ctx,
+                 sdbusplus::async::mutex& mutex, bool& timedOut,
+                 bool& relocked) -> sdbusplus::async::task<> {
+        {
+            sdbusplus::async::lock_guard held{mutex};
+            co_await held.lock();
+
+            try
+            {
+                sdbusplus::async::lock_guard waiting{mutex};
+                co_await sdbusplus::async::with_timeout(ctx, waiting.lock(),
+                                                        10ms);
+            }
+            catch (const sdbusplus::async::timeout_exception&)
+            {
+                timedOut = true;
+            }
+        }
+
+        // The cancelled waiter neither took nor released the lock.
+        sdbusplus::async::lock_guard again{mutex};
+        co_await again.lock();
+        relocked = true;
+
+        ctx.request_stop();
+    }(ctx, mutex, timedOut, relocked));
+    ctx.run();
+
+    EXPECT_TRUE(timedOut);
+    EXPECT_TRUE(relocked);
+}
+
+TEST(Timer, WithTimeoutStopsMatch)
+{
+    sdbusplus::async::context ctx;
+    sdbusplus::async::match m{
+        ctx, sdbusplus::bus::match::rules::type::signal() +
+                 sdbusplus::bus::match::rules::path(
+                     "/xyz/openbmc_project/sdbusplus/test/timeout")};
+
+    bool timedOut = false;
+
+    ctx.spawn([](sdbusplus::async::context& ctx, sdbusplus::async::match& m,
+                 bool& timedOut) -> sdbusplus::async::task<> {
+        try
+        {
+            co_await sdbusplus::async::with_timeout(ctx, m.next(), 10ms);
+        }
+        catch (const sdbusplus::async::timeout_exception&)
+        {
+            timedOut = true;
+        }
+        ctx.request_stop();
+    }(ctx, m, timedOut));
+    ctx.run();
+
+    EXPECT_TRUE(timedOut);
+}
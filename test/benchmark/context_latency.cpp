@@ -0,0 +1,71 @@
+// Round-trip a method call to the dbus broker repeatedly, and report the
+// latency with the context's worker thread and in single-threaded mode.
+//
+//     benchmark-context-latency [count]
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std::literals;
+
+static auto pingPong(sdbusplus::async::context& ctx,
+                     std::vector<std::chrono::nanoseconds>& latencies)
+    -> sdbusplus::async::task<>
+{
+    constexpr auto peer = sdbusplus::async::proxy()
+                              .service("org.freedesktop.DBus")
+                              .path("/org/freedesktop/DBus")
+                              .interface("org.freedesktop.DBus.Peer");
+
+    for (auto& latency : latencies)
+    {
+        auto start = std::chrono::steady_clock::now();
+        co_await peer.call<>(ctx, "Ping");
+        latency = std::chrono::steady_clock::now() - start;
+    }
+
+    ctx.request_stop();
+}
+
+static void report(const char* mode, bool singleThread, size_t count)
+{
+    sdbusplus::async::context ctx{
+        sdbusplus::bus::new_bus(),
+        sdbusplus::async::context_options{.single_thread = singleThread}};
+
+    std::vector<std::chrono::nanoseconds> latencies(count);
+    ctx.spawn(pingPong(ctx, latencies));
+    ctx.run();
+
+    std::ranges::sort(latencies);
+    auto total = std::chrono::nanoseconds{};
+    for (auto l : latencies)
+    {
+        total += l;
+    }
+
+    auto usec = [](std::chrono::nanoseconds ns) {
+        return std::chrono::duration<double, std::micro>(ns).count();
+    };
+
+    std::cout << mode << ": mean " << usec(total / count) << "us, p50 "
+              << usec(latencies[count / 2]) << "us, p99 "
+              << usec(latencies[count * 99 / 100]) << "us\n";
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    count = std::max<size_t>(count, 1);
+
+    std::cout << "Ping round-trips: " << count << "\n";
+    report("worker thread", false, count);
+    report("single thread", true, count);
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Create timers on an event loop from a second thread, while the loop runs,
+// and report the rate through the locked path (`add_oneshot_timer`) and
+// through the submission queue (`submit`).
+//
+//     benchmark-event-timers [count]
+
+#include <sdbusplus/event.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+
+struct timer_handler
+{
+    static int _(sd_event_source*, uint64_t, void*)
+    {
+        return 0;
+    }
+};
+
+// Create 'count' timers from a second thread while this thread runs the
+// loop, returning the time taken.
+template <typename Create>
+auto timerCreation(sdbusplus::event_t& ev, size_t count, Create&& create)
+{
+    std::atomic<size_t> created = 0;
+    std::atomic<bool> done = false;
+    std::chrono::steady_clock::duration elapsed{};
+
+    std::jthread j{[&]() {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i)
+        {
+            create(created);
+        }
+        while (created < count)
+        {
+            std::this_thread::yield();
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+
+        done = true;
+        ev.break_run();
+    }};
+
+    while (!done)
+    {
+        ev.run_one();
+    }
+
+    return elapsed;
+}
+
+struct timer_op
+{
+    static void apply(void* data) noexcept
+    {
+        auto self = static_cast<timer_op*>(data);
+        self->timer = self->ev->add_oneshot_timer(timer_handler::_, nullptr,
+                                                  1h);
+        ++*self->created;
+    }
+
+    sdbusplus::event_t* ev;
+    std::atomic<size_t>* created;
+    sdbusplus::event_source_t timer{};
+    sdbusplus::event_submission_t submission{apply, this};
+};
+
+auto locked(size_t count)
+{
+    sdbusplus::event_t ev{};
+    std::vector<sdbusplus::event_source_t> timers{};
+    timers.reserve(count);
+
+    return timerCreation(ev, count, [&](auto& created) {
+        timers.emplace_back(ev.add_oneshot_timer(timer_handler::_, nullptr, 1h));
+        ++created;
+    });
+}
+
+auto submitted(size_t count)
+{
+    sdbusplus::event_t ev{};
+    std::vector<std::unique_ptr<timer_op>> ops{};
+    ops.reserve(count);
+
+    return timerCreation(ev, count, [&](auto& created) {
+        auto& op = ops.emplace_back(std::make_unique<timer_op>(&ev, &created));
+        ev.submit(op->submission);
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    count = std::max<size_t>(count, 1);
+
+    auto rate = [count](auto elapsed) {
+        return count * 1000000 /
+               std::max<uint64_t>(1, std::chrono::duration_cast<
+                                         std::chrono::microseconds>(elapsed)
+                                         .count());
+    };
+
+    std::cout << "Timers created: " << count << "\n";
+    std::cout << "locked: " << rate(locked(count)) << "/s\n";
+    std::cout << "submitted: " << rate(submitted(count)) << "/s\n";
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Acquire and release uncontended locks repeatedly from a task, and report
+// the cost of each for `async::mutex`, `async::semaphore` and
+// `async::shared_mutex`.
+//
+//     benchmark-locks [count]
+
+#include <sdbusplus/async.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+template <typename Lock>
+static auto lockLoop(sdbusplus::async::context& ctx, size_t count, Lock lock,
+                     std::chrono::nanoseconds& elapsed)
+    -> sdbusplus::async::task<>
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+    {
+        co_await lock();
+    }
+    elapsed = (std::chrono::steady_clock::now() - start) / count;
+
+    ctx.request_stop();
+}
+
+template <typename Lock>
+static void report(const char* name, size_t count, Lock lock)
+{
+    sdbusplus::async::context ctx;
+    std::chrono::nanoseconds elapsed{};
+    ctx.spawn(lockLoop(ctx, count, std::move(lock), elapsed));
+    ctx.run();
+
+    std::cout << name << ": " << elapsed.count() << "ns\n";
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    count = std::max<size_t>(count, 1);
+
+    sdbusplus::async::mutex m{"benchmark"};
+    sdbusplus::async::semaphore s{1};
+    sdbusplus::async::shared_mutex sm{};
+
+    std::cout << "Uncontended lock and unlock: " << count << "\n";
+
+    report("mutex", count, [&]() -> sdbusplus::async::task<> {
+        sdbusplus::async::lock_guard lg{m};
+        co_await lg.lock();
+    });
+    report("semaphore", count, [&]() -> sdbusplus::async::task<> {
+        sdbusplus::async::semaphore_guard sg{s};
+        co_await sg.acquire();
+    });
+    report("shared_mutex exclusive", count, [&]() -> sdbusplus::async::task<> {
+        sdbusplus::async::unique_lock_guard lg{sm};
+        co_await lg.lock();
+    });
+    report("shared_mutex shared", count, [&]() -> sdbusplus::async::task<> {
+        sdbusplus::async::shared_lock_guard lg{sm};
+        co_await lg.lock();
+    });
+
+    return 0;
+}
@@ -1,11 +1,18 @@
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/system/error_code.hpp>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 #include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <chrono>
+#include <map>
 #include <string>
+#include <variant>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -41,3 +48,157 @@ TEST(AioTest, UnpackForwardsMessageOnError)
         });
     EXPECT_TRUE(gotMsg) << "Message should be available in every handler call";
 }
+
+TEST(AioTest, TransactionEmitsSingleInterfacesAdded)
+{
+    using namespace sdbusplus::bus::match;
+    using properties_t = std::map<std::string, std::variant<int, std::string>>;
+
+    boost::asio::io_context io;
+    auto bus = std::make_shared<sdbusplus::asio::connection>(io);
+    sdbusplus::asio::object_server objectServer(bus);
+
+    constexpr auto path = "/xyz/openbmc_project/sdbusplus/test/transaction";
+
+    size_t added = 0;
+    std::map<std::string, properties_t> interfaces;
+    sdbusplus::bus::match_t addedMatch(
+        *bus, rules::interfacesAdded() + rules::sender(bus->get_unique_name()),
+        [&](sdbusplus::message_t& m) {
+            sdbusplus::object_path p;
+            m.read(p, interfaces);
+            ++added;
+        });
+
+    size_t changed = 0;
+    sdbusplus::bus::match_t changedMatch(
+        *bus,
+        rules::type::signal() + rules::member("PropertiesChanged") +
+            rules::path(path),
+        [&](sdbusplus::message_t&) { ++changed; });
+
+    {
+        auto txn = objectServer.begin_transaction(path);
+        auto one = txn.add_interface("xyz.openbmc_project.test.One");
+        one->register_property("Value", 42);
+        auto two = txn.add_interface("xyz.openbmc_project.test.Two");
+        two->register_property("Name", std::string("two"));
+
+        EXPECT_FALSE(one->is_initialized());
+        EXPECT_TRUE(txn.commit());
+        EXPECT_FALSE(txn.commit());
+        EXPECT_TRUE(one->is_initialized());
+        EXPECT_TRUE(two->is_initialized());
+    }
+
+    for (size_t i = 0; (i < 16) && (added == 0); ++i)
+    {
+        io.run_for(std::chrono::milliseconds(100));
+    }
+    io.run_for(std::chrono::milliseconds(100));
+
+    EXPECT_EQ(1u, added);
+    EXPECT_EQ(0u, changed);
+    ASSERT_EQ(2u, interfaces.size());
+    EXPECT_EQ(42, std::get<int>(
+                      interfaces["xyz.openbmc_project.test.One"]["Value"]));
+    EXPECT_EQ("two", std::get<std::string>(
+                         interfaces["xyz.openbmc_project.test.Two"]["Name"]));
+}
+
+TEST(AioTest, DiscardedTransactionRemovesInterfaces)
+{
+    boost::asio::io_context io;
+    auto bus = std::make_shared<sdbusplus::asio::connection>(io);
+    sdbusplus::asio::object_server objectServer(bus);
+
+    std::shared_ptr<sdbusplus::asio::dbus_interface> iface;
+    {
+        auto txn = objectServer.begin_transaction(
+            "/xyz/openbmc_project/sdbusplus/test/discarded");
+        iface = txn.add_interface("xyz.openbmc_project.test.One");
+    }
+
+    EXPECT_FALSE(iface->is_initialized());
+    EXPECT_FALSE(objectServer.remove_interface(iface));
+}
+
+class AioCoroutine : public ::testing::Test
+{
+  protected:
+    static constexpr auto path = "/xyz/openbmc_project/sdbusplus/test/yield";
+    static constexpr auto interface = "xyz.openbmc_project.test.Yield";
+
+    boost::asio::io_context io;
+    std::shared_ptr<sdbusplus::asio::connection> server =
+        std::make_shared<sdbusplus::asio::connection>(io);
+    sdbusplus::asio::object_server objectServer{server};
+    std::shared_ptr<sdbusplus::asio::dbus_interface> iface =
+        objectServer.add_interface(path, interface);
+
+    sdbusplus::bus_t client = sdbusplus::bus::new_bus();
+    size_t handled = 0;
+
+    void send(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto m = client.new_method_call(server->get_unique_name().c_str(),
+                                            path, interface, "Call");
+            ASSERT_LE(0, sd_bus_send(nullptr, m.get(), nullptr));
+        }
+        client.flush();
+    }
+
+    void runUntilHandled(size_t count)
+    {
+        for (size_t i = 0; (i < 50) && (handled < count); ++i)
+        {
+            io.run_for(std::chrono::milliseconds(100));
+        }
+        ASSERT_EQ(count, handled);
+        io.poll();
+    }
+};
+
+TEST_F(AioCoroutine, StacksAreReused)
+{
+    iface->register_method("Call", [this](boost::asio::yield_context) {
+        ++handled;
+        return 0;
+    });
+    iface->initialize();
+
+    for (size_t i = 1; i <= 4; ++i)
+    {
+        send(1);
+        runUntilHandled(i);
+    }
+
+    auto stats = objectServer.get_coroutine_stats();
+    EXPECT_LT(stats.stacks_allocated, 4u);
+    EXPECT_EQ(4u, stats.stacks_allocated + stats.stacks_reused);
+    EXPECT_EQ(0u, stats.active);
+}
+
+TEST_F(AioCoroutine, ConcurrencyLimitQueuesCalls)
+{
+    objectServer.set_coroutine_options({.max_concurrent = 1});
+
+    iface->register_method("Call", [this](boost::asio::yield_context yield) {
+        boost::asio::steady_timer timer(io, std::chrono::milliseconds(10));
+        timer.async_wait(yield);
+        ++handled;
+        return 0;
+    });
+    iface->initialize();
+
+    send(3);
+    runUntilHandled(3);
+
+    auto stats = objectServer.get_coroutine_stats();
+    EXPECT_EQ(1u, stats.peak_active);
+    EXPECT_EQ(2u, stats.peak_queued);
+    EXPECT_EQ(0u, stats.queued);
+    EXPECT_EQ(0u, stats.active);
+}
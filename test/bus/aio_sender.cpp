@@ -0,0 +1,87 @@
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/system_error.hpp>
+#include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/asio/sender.hpp>
+#include <sdbusplus/async.hpp>
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+// Only Senders are spawned by sdbusplus::asio::spawn, leaving any other
+// callable to boost::asio::spawn when both are found by ADL.
+template <typename F>
+concept asio_spawnable = requires(boost::asio::io_context& io, F f) {
+    sdbusplus::asio::spawn(io, std::move(f));
+};
+static_assert(asio_spawnable<sdbusplus::async::task<>>);
+static_assert(!asio_spawnable<void (*)(boost::asio::yield_context)>);
+
+class AioSenderTest : public ::testing::Test
+{
+  protected:
+    ~AioSenderTest() noexcept override = default;
+
+    static auto getId(boost::asio::io_context& io,
+                      sdbusplus::asio::connection& conn, std::string& id)
+        -> sdbusplus::async::task<>
+    {
+        boost::asio::steady_timer timer(io, 1ms);
+        co_await timer.async_wait(sdbusplus::asio::use_sender);
+
+        id = co_await sdbusplus::async::proxy()
+                 .service("org.freedesktop.DBus")
+                 .path("/org/freedesktop/DBus")
+                 .interface("org.freedesktop.DBus")
+                 .call<std::string>(conn, "GetId");
+
+        io.stop();
+    }
+
+    static auto waitCancelled(boost::asio::io_context& io, bool& failed)
+        -> sdbusplus::async::task<>
+    {
+        boost::asio::steady_timer timer(io, 1h);
+        boost::asio::post(io, [&timer]() { timer.cancel(); });
+
+        try
+        {
+            co_await timer.async_wait(sdbusplus::asio::use_sender);
+        }
+        catch (const boost::system::system_error& e)
+        {
+            failed = (e.code() == boost::asio::error::operation_aborted);
+        }
+
+        io.stop();
+    }
+
+    boost::asio::io_context io;
+};
+
+TEST_F(AioSenderTest, RunsTasksOnIoContext)
+{
+    sdbusplus::asio::connection conn(io);
+    std::string id{};
+
+    sdbusplus::asio::spawn(io, getId(io, conn, id));
+    io.run();
+
+    EXPECT_FALSE(id.empty());
+}
+
+TEST_F(AioSenderTest, ErrorsAreThrown)
+{
+    bool failed = false;
+
+    sdbusplus::asio::spawn(io, waitCancelled(io, failed));
+    io.run();
+
+    EXPECT_TRUE(failed);
+}
@@ -1,6 +1,9 @@
 #include <sdbusplus/bus.hpp>
 #include <sdbusplus/bus/match.hpp>
 
+#include <map>
+#include <string>
+
 #include <gtest/gtest.h>
 
 class Match : public ::testing::Test
@@ -93,3 +96,134 @@ TEST_F(Match, FunctorIs_MemberFunctionTakingMessage)
     waitForIt(b.triggered);
     ASSERT_TRUE(b.triggered);
 }
+
+TEST(MatchRule, Parse)
+{
+    using namespace sdbusplus::match_rules;
+
+    auto rule = sdbusplus::bus::match_rule::parse(
+        propertiesChanged("/a/b", "xyz.openbmc_project.Test") +
+        argN(1, "value"));
+
+    EXPECT_EQ((std::map<std::string, std::string>{
+                  {"type", "signal"},
+                  {"path", "/a/b"},
+                  {"member", "PropertiesChanged"},
+                  {"interface", "org.freedesktop.DBus.Properties"},
+                  {"arg0", "xyz.openbmc_project.Test"},
+                  {"arg1", "value"},
+              }),
+              rule.keys);
+
+    rule = sdbusplus::bus::match_rule::parse(R"(arg0='it'\''s')");
+    EXPECT_EQ("it's", *rule.find("arg0"));
+}
+
+TEST(MatchRule, Subsumes)
+{
+    using namespace sdbusplus::match_rules;
+    using sdbusplus::bus::match_rule;
+
+    auto all = match_rule::parse(
+        type::signal() + member("PropertiesChanged") +
+        interface("org.freedesktop.DBus.Properties"));
+    auto one = match_rule::parse(
+        propertiesChanged("/a/b", "xyz.openbmc_project.Test"));
+    auto ns = match_rule::parse(
+        propertiesChangedNamespace("/a", "xyz.openbmc_project"));
+
+    EXPECT_TRUE(all.subsumes(all));
+    EXPECT_TRUE(all.subsumes(one));
+    EXPECT_FALSE(one.subsumes(all));
+    EXPECT_TRUE(ns.subsumes(one));
+    EXPECT_FALSE(ns.subsumes(all));
+
+    // A sender cannot be checked locally, since the daemon matches it
+    // against well-known names.
+    auto sent = match_rule::parse(type::signal() + member("PropertiesChanged") +
+                                  interface("org.freedesktop.DBus.Properties") +
+                                  sender("xyz.openbmc_project.Test"));
+    EXPECT_FALSE(all.subsumes(sent));
+    EXPECT_TRUE(sent.subsumes(sent));
+}
+
+TEST_F(Match, SharedMatchesShareRegistration)
+{
+    using namespace sdbusplus::match_rules;
+
+    bool broad = false;
+    bool narrow = false;
+    bool other = false;
+
+    auto mux = sdbusplus::bus::match_mux::get(bus);
+
+    sdbusplus::match m1{bus, matchRule(),
+                        [&](sdbusplus::message_t&) { narrow = true; },
+                        sdbusplus::match::shared};
+    EXPECT_EQ(1u, mux->registrations());
+
+    // A broader rule takes over the registration of the narrower one.
+    sdbusplus::match m2{bus, nameOwnerChanged(),
+                        [&](sdbusplus::message_t&) { broad = true; },
+                        sdbusplus::match::shared};
+    EXPECT_EQ(1u, mux->registrations());
+
+    // A narrower rule is filtered locally.
+    sdbusplus::match m3{
+        bus, nameOwnerChanged() + argN(0, "xyz.openbmc_project.NotThere"),
+        [&](sdbusplus::message_t&) { other = true; }, sdbusplus::match::shared};
+    EXPECT_EQ(1u, mux->registrations());
+
+    bus.request_name(busName);
+
+    waitForIt(narrow);
+    EXPECT_TRUE(narrow);
+    EXPECT_TRUE(broad);
+    EXPECT_FALSE(other);
+}
+
+TEST_F(Match, SharedMatchesIndexedOnMemberAndInterface)
+{
+    using namespace sdbusplus::match_rules;
+
+    static constexpr auto path = "/xyz/openbmc_project/sdbusplus/test/mux";
+    static constexpr auto iface = "xyz.openbmc_project.sdbusplus.test.Mux";
+
+    size_t all = 0;
+    bool done = false;
+    bool byMember = false;
+    bool byInterface = false;
+    bool other = false;
+
+    auto mux = sdbusplus::bus::match_mux::get(bus);
+
+    sdbusplus::match m1{bus, type::signal() + path_namespace(path),
+                        [&](sdbusplus::message_t&) { done = (++all == 2); },
+                        sdbusplus::match::shared};
+
+    // The narrower rules are indexed on their member or interface.
+    sdbusplus::match m2{bus,
+                        type::signal() + path_namespace(path) + member("One"),
+                        [&](sdbusplus::message_t&) { byMember = true; },
+                        sdbusplus::match::shared};
+    sdbusplus::match m3{
+        bus, type::signal() + path_namespace(path) + interface(iface),
+        [&](sdbusplus::message_t&) { byInterface = true; },
+        sdbusplus::match::shared};
+    sdbusplus::match m4{
+        bus,
+        type::signal() + path_namespace(path) +
+            interface("xyz.openbmc_project.sdbusplus.test.NotThere"),
+        [&](sdbusplus::message_t&) { other = true; }, sdbusplus::match::shared};
+    EXPECT_EQ(1u, mux->registrations());
+
+    bus.new_signal(path, iface, "One").signal_send();
+    bus.new_signal(path, "xyz.openbmc_project.sdbusplus.test.Other", "Two")
+        .signal_send();
+
+    waitForIt(done);
+    EXPECT_TRUE(done);
+    EXPECT_TRUE(byMember);
+    EXPECT_TRUE(byInterface);
+    EXPECT_FALSE(other);
+}
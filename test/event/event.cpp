@@ -2,6 +2,7 @@
 
 #include <sdbusplus/event.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <thread>
 
@@ -86,3 +87,66 @@ TEST_F(Event, Timer)
     EXPECT_TRUE(stop - start > timeout);
     EXPECT_TRUE(stop - start < timeout * tolerance);
 }
+
+TEST(EventShared, DispatchesForeignSources)
+{
+    struct handler
+    {
+        static int _(sd_event_source*, uint64_t, void* data)
+        {
+            *static_cast<bool*>(data) = true;
+            return 0;
+        }
+    };
+
+    sd_event* e = nullptr;
+    ASSERT_LE(0, sd_event_new(&e));
+
+    {
+        sdbusplus::event_t ev{e};
+        EXPECT_EQ(e, ev.get());
+
+        // A source added by other code, directly on the sd_event.
+        bool ran = false;
+        sd_event_source* s = nullptr;
+        ASSERT_LE(0, sd_event_add_time_relative(e, &s, CLOCK_MONOTONIC, 1000,
+                                                0, handler::_, &ran));
+
+        ev.run_one(1s);
+        EXPECT_TRUE(ran);
+
+        sd_event_source_unref(s);
+    }
+
+    // The sd_event is still usable by its owner.
+    EXPECT_LE(0, sd_event_get_state(e));
+    sd_event_unref(e);
+}
+
+TEST_F(Event, SubmissionApplied)
+{
+    struct handler
+    {
+        static void _(void* data) noexcept
+        {
+            ++*static_cast<std::atomic<int>*>(data);
+        }
+    };
+    std::atomic<int> ran = 0;
+
+    // Without a running loop the submission is applied by the caller.
+    sdbusplus::event_submission_t s{handler::_, &ran};
+    ev.submit(s);
+    EXPECT_EQ(1, ran);
+
+    // With a running loop it is applied by the loop thread, which is woken.
+    std::jthread j{[&]() {
+        std::this_thread::sleep_for(10ms);
+        ev.submit(s);
+    }};
+    while (ran < 2)
+    {
+        ev.run_one(1s);
+    }
+    EXPECT_EQ(2, ran);
+}
@@ -0,0 +1,101 @@
+#include <sdbusplus/async.hpp>
+#include <server/TestWithMethod/aserver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::literals;
+
+class A : public sdbusplus::aserver::server::TestWithMethod<A>
+{
+  public:
+    using sdbusplus::aserver::server::TestWithMethod<A>::TestWithMethod;
+
+    auto method_call(sdbusplus::common::server::TestWithMethod::update_value_t,
+                     EnumOne) -> sdbusplus::async::task<bool>
+    {
+        peak = std::max(peak, ++inFlight);
+        co_await sdbusplus::async::sleep_for(ctx, 50ms);
+        --inFlight;
+        co_return true;
+    }
+
+    int inFlight = 0;
+    int peak = 0;
+};
+
+struct Results
+{
+    int succeeded = 0;
+    int rejected = 0;
+    int done = 0;
+};
+
+auto call(sdbusplus::async::context& ctx, std::string name, Results& results)
+    -> sdbusplus::async::task<>
+{
+    auto this_service = sdbusplus::async::proxy()
+                            .service(name)
+                            .path("/xyz/openbmc_project/test/aserver")
+                            .interface("server.TestWithMethod");
+
+    try
+    {
+        if (co_await this_service.call<bool>(
+                ctx, "UpdateValue",
+                sdbusplus::common::server::TestWithMethod::EnumOne::OneA))
+        {
+            ++results.succeeded;
+        }
+    }
+    catch (const sdbusplus::exception::SdBusError& e)
+    {
+        if (std::strcmp(e.name(),
+                        "org.freedesktop.DBus.Error.LimitsExceeded") == 0)
+        {
+            ++results.rejected;
+        }
+    }
+
+    if (++results.done == 3)
+    {
+        ctx.request_stop();
+    }
+}
+
+TEST(AServerMethodLimits, QueuesAndRejects)
+{
+    sdbusplus::async::context ctx;
+
+    auto bus_name = std::format("xyz.openbmc_project.TestingMethodLimits_{}",
+                                std::this_thread::get_id());
+
+    ctx.request_name(bus_name.c_str());
+
+    A server(ctx, "/xyz/openbmc_project/test/aserver");
+    server.set_method_limits({.max_concurrent = 1, .max_queued = 1});
+
+    Results results{};
+    for (auto i = 0; i < 3; ++i)
+    {
+        ctx.spawn(call(ctx, bus_name, results));
+    }
+    ctx.run();
+
+    // One call ran, one waited for it, and one was turned away.
+    EXPECT_EQ(2, results.succeeded);
+    EXPECT_EQ(1, results.rejected);
+    EXPECT_EQ(1, server.peak);
+
+    auto stats = server.get_method_stats();
+    EXPECT_EQ(2u, stats.admitted);
+    EXPECT_EQ(1u, stats.queued);
+    EXPECT_EQ(1u, stats.rejected);
+    EXPECT_EQ(0u, stats.running);
+    EXPECT_EQ(0u, stats.waiting);
+}
@@ -164,3 +164,21 @@ TEST_F(Object, DoubleHasDefaultValues)
                 std::signbit(test->doubleAsNegInf()));
     EXPECT_EQ(std::numeric_limits<double>::epsilon(), test->doubleAsEpsilon());
 }
+
+TEST_F(Object, SignalPolicySuppressesSmallChanges)
+{
+    auto test = std::make_unique<TestInherit>(
+        bus, objPath, TestInherit::action::emit_no_signals);
+    test->setSignalPolicy("SomeValue", {.absolute_deadband = 10});
+
+    // The first change and the change outside the deadband are signalled;
+    // the one inside it is not.
+    EXPECT_CALL(sdbusMock, sd_bus_emit_properties_changed_strv(
+                               _, StrEq(objPath), _, _))
+        .Times(2);
+
+    test->someValue(1);
+    test->someValue(5);
+    EXPECT_EQ(5, test->someValue());
+    test->someValue(20);
+}
@@ -0,0 +1,94 @@
+#include <sdbusplus/server/signal_policy.hpp>
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using sdbusplus::server::signal_policy;
+using sdbusplus::server::signal_throttle;
+using namespace std::literals::chrono_literals;
+
+class SignalThrottle : public ::testing::Test
+{
+  protected:
+    signal_throttle::clock::time_point start = signal_throttle::clock::now();
+};
+
+TEST_F(SignalThrottle, NoPolicySignalsEveryChange)
+{
+    signal_throttle t{signal_policy{}};
+
+    EXPECT_TRUE(t.changed(1.0, start));
+    EXPECT_TRUE(t.changed(1.5, start));
+    EXPECT_TRUE(t.changed(std::nullopt, start));
+    EXPECT_FALSE(t.deadline());
+}
+
+TEST_F(SignalThrottle, AbsoluteDeadband)
+{
+    signal_throttle t{{.absolute_deadband = 1.0}};
+
+    EXPECT_TRUE(t.changed(10.0, start));
+    EXPECT_FALSE(t.changed(10.5, start));
+    EXPECT_FALSE(t.changed(9.5, start));
+    // Measured from the last signalled value, not the last change.
+    EXPECT_TRUE(t.changed(11.0, start));
+
+    // Without max_staleness a suppressed change is never sent.
+    EXPECT_FALSE(t.changed(11.5, start));
+    EXPECT_FALSE(t.deadline());
+}
+
+TEST_F(SignalThrottle, RelativeDeadband)
+{
+    signal_throttle t{{.relative_deadband = 0.1}};
+
+    EXPECT_TRUE(t.changed(100.0, start));
+    EXPECT_FALSE(t.changed(109.0, start));
+    EXPECT_TRUE(t.changed(111.0, start));
+}
+
+TEST_F(SignalThrottle, NonNumericIgnoresDeadband)
+{
+    signal_throttle t{{.absolute_deadband = 1.0}};
+
+    EXPECT_TRUE(t.changed(std::nullopt, start));
+    EXPECT_TRUE(t.changed(std::nullopt, start));
+}
+
+TEST_F(SignalThrottle, MinIntervalSendsTrailingSignal)
+{
+    signal_throttle t{{.min_interval = 100ms}};
+
+    EXPECT_TRUE(t.changed(1.0, start));
+    EXPECT_FALSE(t.changed(2.0, start + 10ms));
+    EXPECT_FALSE(t.changed(3.0, start + 20ms));
+
+    ASSERT_TRUE(t.deadline());
+    EXPECT_EQ(start + 100ms, *t.deadline());
+
+    EXPECT_FALSE(t.expired(start + 99ms));
+    EXPECT_TRUE(t.expired(start + 100ms));
+    EXPECT_FALSE(t.deadline());
+
+    // The interval restarts from the trailing signal.
+    EXPECT_FALSE(t.changed(4.0, start + 150ms));
+    EXPECT_TRUE(t.changed(5.0, start + 200ms));
+}
+
+TEST_F(SignalThrottle, MaxStalenessFlushesDeadband)
+{
+    signal_throttle t{{.absolute_deadband = 1.0, .max_staleness = 1s}};
+
+    EXPECT_TRUE(t.changed(1.0, start));
+    EXPECT_FALSE(t.changed(1.5, start + 10ms));
+
+    ASSERT_TRUE(t.deadline());
+    EXPECT_EQ(start + 1s, *t.deadline());
+    EXPECT_TRUE(t.expired(start + 1s));
+
+    // Returning to the signalled value leaves nothing stale.
+    EXPECT_FALSE(t.changed(1.2, start + 1100ms));
+    EXPECT_FALSE(t.changed(1.5, start + 1200ms));
+    EXPECT_FALSE(t.deadline());
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <sdbusplus/async/server.hpp>
+#include <sdbusplus/async/timer.hpp>
 #include <sdbusplus/server/interface.hpp>
 #include <sdbusplus/server/transaction.hpp>
 
@@ -49,11 +50,11 @@ class ${interface.classname} :
   public:
     explicit ${interface.classname}(const char* path) :
         _${interface.joinedName("_", "interface")}(
-            _context(), path, interface, _vtable, this)
+            _bus(), path, interface, _vtable, this)
     {}
     explicit ${interface.classname}(const sdbusplus::object_path& path) :
         _${interface.joinedName("_", "interface")}(
-            _context(), path, interface, _vtable, this)
+            _bus(), path, interface, _vtable, this)
     {}
 
     ${interface.classname}(
@@ -88,6 +89,46 @@ ${s.render(loader, "signal.aserver.emit.hpp.mako", signal=s, interface=interface
         _${interface.joinedName("_", "interface")}.emit_removed();
     }
 
+% if interface.properties:
+    /** @brief Limit the change signals sent for a property.
+     *
+     *  @param[in] property - The property name.
+     *  @param[in] policy - The signalling policy to apply.
+     */
+    void set_signal_policy(const char* property,
+                           const sdbusplus::server::signal_policy& policy)
+    {
+        _${interface.joinedName("_", "interface")}.set_signal_timer(
+            [this](std::chrono::microseconds delay,
+                   sdbusplus::server::interface_t::signal_flush flush) {
+                if (_context().stop_requested())
+                {
+                    return;
+                }
+                _context().spawn(
+                    sdbusplus::async::sleep_for(_context(), delay) |
+                    sdbusplus::async::execution::then(std::move(flush)));
+            });
+        _${interface.joinedName("_", "interface")}.set_signal_policy(
+            property, policy);
+    }
+
+% endif
+    /** @brief Limit the asynchronous method calls run at once.
+     *
+     *  @param[in] limits - The limits, set before any calls are handled.
+     */
+    void set_method_limits(const sdbusplus::async::method_limits& limits)
+    {
+        _method_admission.set_limits(limits);
+    }
+
+    /** @return the counters of the asynchronous method calls */
+    auto get_method_stats() const -> sdbusplus::async::method_stats
+    {
+        return _method_admission.get_stats();
+    }
+
 % for p in interface.properties:
 ${p.render(loader, "property.aserver.get.hpp.mako", property=p, interface=interface)}
 % endfor
@@ -108,9 +149,18 @@ ${p.render(loader, "property.aserver.set.hpp.mako", property=p, interface=interf
             context<Server, ${interface.classname}>(this);
     }
 
+    /** @return the bus the server is registered on */
+    sdbusplus::bus_t& _bus()
+    {
+        return server_details::server_context_friend::
+            bus<Server, ${interface.classname}>(this);
+    }
+
     sdbusplus::server::interface_t
         _${interface.joinedName("_", "interface")};
 
+    server_details::method_admission _method_admission{};
+
 % for p in interface.properties:
 ${p.render(loader, "property.aserver.typeid.hpp.mako", property=p, interface=interface)}\
 % endfor
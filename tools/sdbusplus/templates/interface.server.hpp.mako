@@ -109,6 +109,17 @@ ${p.camelCase}(${p.cppTypeParam(interface.name)} value);
          */
         PropertiesVariant getPropertyByName(const std::string& _name);
 
+        /** @brief Limits the change signals sent for a property.
+         *  @param[in] _name - A string representation of the property name.
+         *  @param[in] policy - The signalling policy to apply.
+         */
+        void setSignalPolicy(const std::string& _name,
+                             const sdbusplus::server::signal_policy& policy)
+        {
+            _${interface.joinedName("_", "interface")}.set_signal_policy(
+                _name.c_str(), policy);
+        }
+
     % endif
 
 
@@ -93,8 +93,17 @@ self_i->method_call(${m_tag}{}, m\
                 }
                 else
                 {
+                    auto call = self->_method_admission.admit();
+                    if (call.rejected())
+                    {
+                        return sd_bus_error_set(
+                            error, SD_BUS_ERROR_LIMITS_EXCEEDED,
+                            "Too many calls in progress");
+                    }
+
                     auto fn = [](auto self, auto self_i,
-                                 sdbusplus::message_t m\
+                                 sdbusplus::message_t m,
+                                 server_details::admitted_call call\
 % if m_param_count:
 ,
                                  ${m_pargs}\
@@ -102,6 +111,11 @@ self_i->method_call(${m_tag}{}, m\
 )
                             -> sdbusplus::async::task<>
                     {
+                        if (call.queued())
+                        {
+                            co_await call.acquire();
+                        }
+
                         try
                         {
 
@@ -137,14 +151,14 @@ co_await self_i->method_call(
 % endfor
                         catch(const std::exception&)
                         {
-                            self->_context().get_bus().set_current_exception(
+                            self->_bus().set_current_exception(
                                 std::current_exception());
                             co_return;
                         }
                     };
 
                     self->_context().spawn(
-                        std::move(fn(self, self_i, m\
+                        std::move(fn(self, self_i, m, std::move(call)\
 % if m_param_count:
 , ${m_pmove}\
 % endif
@@ -187,8 +201,17 @@ self_i->method_call(${m_tag}{}\
                 }
                 else
                 {
+                    auto call = self->_method_admission.admit();
+                    if (call.rejected())
+                    {
+                        return sd_bus_error_set(
+                            error, SD_BUS_ERROR_LIMITS_EXCEEDED,
+                            "Too many calls in progress");
+                    }
+
                     auto fn = [](auto self, auto self_i,
-                                 sdbusplus::message_t m\
+                                 sdbusplus::message_t m,
+                                 server_details::admitted_call call\
 % if m_param_count:
 ,
                                  ${m_pargs}\
@@ -196,6 +219,11 @@ self_i->method_call(${m_tag}{}\
 )
                             -> sdbusplus::async::task<>
                     {
+                        if (call.queued())
+                        {
+                            co_await call.acquire();
+                        }
+
                         try
                         {
 
@@ -231,14 +259,14 @@ co_await self_i->method_call(
                         % endfor
                         catch(const std::exception&)
                         {
-                            self->_context().get_bus().set_current_exception(
+                            self->_bus().set_current_exception(
                                 std::current_exception());
                             co_return;
                         }
                     };
 
                     self->_context().spawn(
-                        std::move(fn(self, self_i, m\
+                        std::move(fn(self, self_i, m, std::move(call)\
 % if m_param_count:
 , ${m_pmove}\
 % endif
@@ -254,7 +282,7 @@ co_await self_i->method_call(
 % endfor
         catch(const std::exception&)
         {
-            self->_context().get_bus().set_current_exception(
+            self->_bus().set_current_exception(
                 std::current_exception());
             return -EINVAL;
         }
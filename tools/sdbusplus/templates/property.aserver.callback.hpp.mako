@@ -43,7 +43,7 @@ i_name = interface.classname
         % endfor
         catch (const std::exception&)
         {
-            self->_context().get_bus().set_current_exception(
+            self->_bus().set_current_exception(
                 std::current_exception());
             return -EINVAL;
         }
@@ -95,7 +95,7 @@ i_name = interface.classname
         % endfor
         catch (const std::exception&)
         {
-            self->_context().get_bus().set_current_exception(
+            self->_bus().set_current_exception(
                 std::current_exception());
             return -EINVAL;
         }
@@ -14,7 +14,15 @@ i_name = interface.joinedName("_", "interface")
 
         if (changed && EmitSignal)
         {
-            _${i_name}.property_changed("${property.name}");
+            if constexpr (!server_details::has_get_property_msg<${p_tag},
+                                                                Instance>)
+            {
+                _${i_name}.property_changed("${property.name}", ${p_name}());
+            }
+            else
+            {
+                _${i_name}.property_changed("${property.name}");
+            }
         }
     }
 
@@ -28,7 +36,15 @@ i_name = interface.joinedName("_", "interface")
 
         if (changed && EmitSignal)
         {
-            _${i_name}.property_changed("${property.name}");
+            if constexpr (!server_details::has_get_property_msg<${p_tag},
+                                                                Instance>)
+            {
+                _${i_name}.property_changed("${property.name}", ${p_name}());
+            }
+            else
+            {
+                _${i_name}.property_changed("${property.name}");
+            }
         }
     }
 
@@ -46,6 +62,7 @@ i_name = interface.joinedName("_", "interface")
 
         if (changed && EmitSignal)
         {
-            _${i_name}.property_changed("${property.name}");
+            _${i_name}.property_changed("${property.name}",
+                                        properties.${p_name});
         }
     }
@@ -44,7 +44,8 @@ auto ${interface.classname}::${property.camelCase}(${property.cppTypeParam(inter
         _${property.camelCase} = value;
         if (!skipSignal)
         {
-            _${interface.joinedName("_", "interface")}.property_changed("${property.name}");
+            _${interface.joinedName("_", "interface")}.property_changed(
+                "${property.name}", _${property.camelCase});
         }
     }
 